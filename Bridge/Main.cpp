@@ -0,0 +1,800 @@
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/JP8080Bridge.h"
+#include "../Source/JP8080OfflineRenderer.h"
+#include "../Source/JP8080Emulator.h"
+
+#include <csignal>
+#include <iostream>
+#include <set>
+
+//==============================================================================
+/**
+ * JP8080Bridge: headless front end for the controller engine
+ *
+ *   JP8080Bridge --list
+ *   JP8080Bridge --output <port> [--input <port>] [--socket <path>] [--osc <udp port>]
+ *   JP8080Bridge --benchmark [seconds]
+ *   JP8080Bridge --render <timeline.csv> <seconds> <out.mid> [out.syx]
+ *   JP8080Bridge --replay <timeline.csv> <seconds> <golden.txt> [--update]
+ *   JP8080Bridge --check [iterations] [seed]
+ *   JP8080Bridge --emulate <timeline.csv> <seconds> [--buffer <bytes>]
+ *   JP8080Bridge --virtual-synth [name] [--buffer <bytes>]
+ *
+ * Ports are matched by identifier or by name.
+ *
+ * --replay runs a timeline (parameter changes, state restores and lock
+ * sequencer edits, see JP8080OfflineRenderer.h) and compares every emitted
+ * byte and its sample position with a golden file, which --update records;
+ * Bridge/Timelines/replay_all.sh runs the committed timelines. --check
+ * compares the Roland checksum with the messages in SYSEX_TEST_GUIDE.md and
+ * with random data, and the bank select / program change mapping with the
+ * table in plan.md. Both exit with 1 on a mismatch.
+ *
+ * --emulate plays a timeline's output into the JP-8080 emulator (see
+ * JP8080Emulator.h) as if over a MIDI cable, prints its statistics and
+ * exits with 1 if the emulated temporary patch doesn't end up matching the
+ * parameters. --virtual-synth serves the emulator on a virtual MIDI port
+ * pair for the plugin or a bridge to connect to; SIGUSR1 pulls and
+ * reconnects its cable.
+ */
+namespace
+{
+    std::atomic<bool> shutdownRequested { false };
+    std::atomic<bool> cableToggleRequested { false };
+
+    void handleShutdownSignal (int)
+    {
+        shutdownRequested = true;
+    }
+
+   #ifdef SIGUSR1
+    void handleCableToggleSignal (int)
+    {
+        cableToggleRequested = true;
+    }
+   #endif
+
+    // Signal handlers can't touch the message loop, so it polls the flag
+    struct ShutdownPoller : private juce::Timer
+    {
+        ShutdownPoller()            { startTimer (100); }
+
+        void timerCallback() override
+        {
+            if (shutdownRequested)
+                juce::MessageManager::getInstance()->stopDispatchLoop();
+        }
+    };
+
+    juce::String findDevice (const juce::Array<juce::MidiDeviceInfo>& devices, const juce::String& nameOrId)
+    {
+        for (const auto& device : devices)
+            if (device.identifier == nameOrId || device.name == nameOrId)
+                return device.identifier;
+
+        return {};
+    }
+
+    void printDevices()
+    {
+        std::cout << "Outputs:" << std::endl;
+        for (const auto& device : juce::MidiOutput::getAvailableDevices())
+            std::cout << "  " << device.name << "  [" << device.identifier << "]" << std::endl;
+
+        std::cout << "Inputs:" << std::endl;
+        for (const auto& device : juce::MidiInput::getAvailableDevices())
+            std::cout << "  " << device.name << "  [" << device.identifier << "]" << std::endl;
+    }
+
+    //==============================================================================
+    int runBridge (const juce::StringArray& args)
+    {
+        JP8080ControllerAudioProcessor processor;
+
+        const auto outputId = findDevice (processor.getAvailableMidiOutputs(), args[args.indexOf ("--output") + 1]);
+        if (outputId.isEmpty())
+        {
+            std::cerr << "MIDI output not found" << std::endl;
+            return 1;
+        }
+
+        processor.setSelectedMidiOutput (outputId);
+
+        juce::String controllerInputId;
+        if (args.contains ("--input"))
+        {
+            controllerInputId = findDevice (juce::MidiInput::getAvailableDevices(), args[args.indexOf ("--input") + 1]);
+
+            if (controllerInputId.isEmpty())
+            {
+                std::cerr << "MIDI input not found" << std::endl;
+                return 1;
+            }
+        }
+
+        const auto socketPath = args.contains ("--socket") ? args[args.indexOf ("--socket") + 1] : juce::String();
+
+        if (args.contains ("--osc") && ! processor.setOSCPort (args[args.indexOf ("--osc") + 1].getIntValue()))
+        {
+            std::cerr << "Could not open the OSC port" << std::endl;
+            return 1;
+        }
+
+        JP8080Bridge bridge (processor);
+
+        if (! bridge.start (controllerInputId, socketPath))
+        {
+            std::cerr << "Could not open the controller input or the socket" << std::endl;
+            return 1;
+        }
+
+        std::signal (SIGINT, handleShutdownSignal);
+        std::signal (SIGTERM, handleShutdownSignal);
+
+        ShutdownPoller shutdownPoller;
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        bridge.stop();
+        std::cout << processor.getMetrics().toJSON() << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // Change-to-emission latency and throughput at one block size. Parameter
+    // changes arrive from another thread, as they would from a controller.
+    // Latency is measured from the first unsent change of a parameter to the
+    // end of the block that picks it up.
+    juce::var runBenchmark (const juce::String& name, double sampleRate, int blockSize, bool sendDirect, double seconds)
+    {
+        JP8080ControllerAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        std::vector<juce::RangedAudioParameter*> knobs;
+        for (const auto& paramID : JP8080Parameters::getAllParameterIDs())
+            knobs.push_back (processor.getValueTreeState().getParameter (paramID));
+
+        std::array<std::atomic<juce::int64>, 64> changeTicks {};
+        JP8080Metrics::Histogram latency;
+        std::atomic<juce::int64> numEmitted { 0 };
+        juce::int64 numChanges = 0;
+
+        struct BlockTimer : public juce::HighResolutionTimer
+        {
+            void hiResTimerCallback() override      { callback(); }
+            std::function<void()> callback;
+        };
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midiMessages;
+        std::array<juce::int64, 64> blockChanges {};
+
+        BlockTimer blockTimer;
+        blockTimer.callback = [&]
+        {
+            for (size_t i = 0; i < knobs.size(); ++i)
+                blockChanges[i] = changeTicks[i].exchange (0);
+
+            midiMessages.clear();
+            processor.processBlock (buffer, midiMessages);
+
+            if (sendDirect)
+                processor.sendMidiBufferDirect (midiMessages);
+
+            numEmitted += midiMessages.getNumEvents();
+
+            const auto now = juce::Time::getHighResolutionTicks();
+            for (size_t i = 0; i < knobs.size(); ++i)
+                if (blockChanges[i] != 0)
+                    latency.record (JP8080Metrics::ticksToMicros (now - blockChanges[i]));
+        };
+
+        const int blockIntervalMs = juce::jmax (1, juce::roundToInt (1000.0 * blockSize / sampleRate));
+        blockTimer.startTimer (blockIntervalMs);
+
+        // About 5000 changes per second, spread over all knobs
+        juce::Random random (1);
+        const auto changeIntervalTicks = juce::Time::secondsToHighResolutionTicks (0.0002);
+        const auto endTicks = juce::Time::getHighResolutionTicks() + juce::Time::secondsToHighResolutionTicks (seconds);
+        auto nextChange = juce::Time::getHighResolutionTicks();
+
+        while (juce::Time::getHighResolutionTicks() < endTicks)
+        {
+            if (juce::Time::getHighResolutionTicks() < nextChange)
+            {
+                juce::Thread::yield();
+                continue;
+            }
+
+            const auto index = static_cast<size_t> (random.nextInt (static_cast<int> (knobs.size())));
+            juce::int64 unsent = 0;
+            changeTicks[index].compare_exchange_strong (unsent, juce::Time::getHighResolutionTicks());
+
+            knobs[index]->setValueNotifyingHost (knobs[index]->convertTo0to1 (static_cast<float> (random.nextInt (128))));
+            ++numChanges;
+            nextChange += changeIntervalTicks;
+        }
+
+        blockTimer.stopTimer();
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("path", name);
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("blockIntervalMs", blockIntervalMs);
+        result->setProperty ("parameterChanges", numChanges);
+        result->setProperty ("messagesPerSecond", static_cast<double> (numEmitted.load()) / seconds);
+        result->setProperty ("changeToEmission", latency.toVar());
+        result->setProperty ("processBlock", processor.getMetrics().processBlockTime.toVar());
+        return juce::var (result);
+    }
+
+    int runBenchmarks (const juce::StringArray& args)
+    {
+        const double seconds = args.size() > 1 ? juce::jmax (0.1, args[1].getDoubleValue()) : 5.0;
+
+        juce::Array<juce::var> results;
+        results.add (runBenchmark ("bridge", JP8080Bridge::sampleRate, JP8080Bridge::samplesPerTick, true, seconds));
+        results.add (runBenchmark ("plugin", 44100.0, 512, false, seconds));
+
+        std::cout << juce::JSON::toString (juce::var (results)) << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    int runRender (const juce::StringArray& args)
+    {
+        if (args.size() < 4)
+        {
+            std::cerr << "Usage: --render <timeline.csv> <seconds> <out.mid> [out.syx]" << std::endl;
+            return 1;
+        }
+
+        const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+        std::vector<JP8080OfflineRenderer::AutomationPoint> timeline;
+        if (! JP8080OfflineRenderer::loadTimelineFromCSV (workingDirectory.getChildFile (args[1]), timeline))
+        {
+            std::cerr << "Could not read " << args[1] << std::endl;
+            return 1;
+        }
+
+        const auto syxFile = args.size() > 4 ? workingDirectory.getChildFile (args[4]) : juce::File();
+
+        JP8080ControllerAudioProcessor processor;
+        JP8080OfflineRenderer renderer (processor);
+        const auto result = renderer.render (std::move (timeline), args[2].getDoubleValue(),
+                                             workingDirectory.getChildFile (args[3]), syxFile);
+
+        if (! result.ok)
+        {
+            std::cerr << result.error << std::endl;
+            return 1;
+        }
+
+        std::cout << result.numMidiEvents << " MIDI events, " << result.numSysExMessages << " SysEx messages in "
+                  << result.renderMs << " ms" << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // One line per message: "<sample position> <out|direct> <hex bytes>"
+    int runReplay (const juce::StringArray& args)
+    {
+        if (args.size() < 4)
+        {
+            std::cerr << "Usage: --replay <timeline.csv> <seconds> <golden.txt> [--update]" << std::endl;
+            return 1;
+        }
+
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+
+        const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+
+        std::vector<JP8080OfflineRenderer::AutomationPoint> timeline;
+        if (! JP8080OfflineRenderer::loadTimelineFromCSV (workingDirectory.getChildFile (args[1]), timeline))
+        {
+            std::cerr << "Could not read " << args[1] << " or a state it restores" << std::endl;
+            return 1;
+        }
+
+        juce::StringArray lines;
+        lines.add ("# JP8080 replay, " + juce::String (sampleRate, 0) + " Hz, " + juce::String (blockSize) + " samples per block");
+
+        JP8080ControllerAudioProcessor processor;
+        JP8080OfflineRenderer renderer (processor);
+        const auto result = renderer.replay (std::move (timeline), args[2].getDoubleValue(),
+                                             [&] (juce::int64 samplePosition, const uint8_t* data, int size, bool direct)
+        {
+            lines.add (juce::String (samplePosition) + (direct ? " direct " : " out ")
+                         + juce::String::toHexString (data, size).toUpperCase());
+        }, sampleRate, blockSize);
+
+        if (! result.ok)
+        {
+            std::cerr << result.error << std::endl;
+            return 1;
+        }
+
+        const auto goldenFile = workingDirectory.getChildFile (args[3]);
+
+        if (args.contains ("--update"))
+        {
+            if (! goldenFile.replaceWithText (lines.joinIntoString ("\n") + "\n"))
+            {
+                std::cerr << "Could not write " << args[3] << std::endl;
+                return 1;
+            }
+
+            std::cout << "Wrote " << lines.size() - 1 << " messages to " << args[3] << std::endl;
+            return 0;
+        }
+
+        if (! goldenFile.existsAsFile())
+        {
+            std::cerr << "No golden file " << args[3] << ", record it with --update" << std::endl;
+            return 1;
+        }
+
+        juce::StringArray expected;
+        expected.addLines (goldenFile.loadFileAsString());
+        expected.removeEmptyStrings();
+
+        for (int i = 0; i < juce::jmax (lines.size(), expected.size()); ++i)
+        {
+            if (lines[i] == expected[i])
+                continue;
+
+            std::cerr << args[3] << ":" << i + 1 << ": mismatch" << std::endl
+                      << "  expected: " << (i < expected.size() ? expected[i] : "(end of file)") << std::endl
+                      << "  actual:   " << (i < lines.size() ? lines[i] : "(end of output)") << std::endl;
+            return 1;
+        }
+
+        std::cout << lines.size() - 1 << " messages match " << args[3] << std::endl;
+        return 0;
+    }
+
+    //==============================================================================
+    // DT1 messages from SYSEX_TEST_GUIDE.md, checksums worked out by hand
+    const char* const documentedDataSets[] = {
+        "F0 41 10 00 06 12 01 00 40 10 00 2F F7",   // LFO1 TRI
+        "F0 41 10 00 06 12 01 00 40 10 01 2E F7",   // LFO1 SAW
+        "F0 41 10 00 06 12 01 00 40 10 02 2D F7",   // LFO1 SQR
+        "F0 41 10 00 06 12 01 00 40 10 03 2C F7",   // LFO1 S/H
+        "F0 41 10 00 06 12 01 00 40 1E 00 21 F7",   // OSC1 SUPER SAW
+        "F0 41 10 00 06 12 01 00 40 1E 01 20 F7",   // OSC1 TRIANGLE MOD
+        "F0 41 10 00 06 12 01 00 40 1E 02 1F F7",   // OSC1 NOISE
+        "F0 41 10 00 06 12 01 00 40 1E 03 1E F7",   // OSC1 FEEDBACK OSC
+        "F0 41 10 00 06 12 01 00 40 1E 04 1D F7",   // OSC1 SQR (PWM)
+        "F0 41 10 00 06 12 01 00 40 1E 05 1C F7",   // OSC1 SAW
+        "F0 41 10 00 06 12 01 00 40 1E 06 1B F7",   // OSC1 TRI
+        "F0 41 10 00 06 12 01 00 40 21 00 1E F7",   // OSC2 SQR (PWM)
+        "F0 41 10 00 06 12 01 00 40 21 01 1D F7",   // OSC2 SAW
+        "F0 41 10 00 06 12 01 00 40 21 02 1C F7",   // OSC2 TRI
+        "F0 41 10 00 06 12 01 00 40 21 03 1B F7"    // OSC2 NOISE
+    };
+
+    // The documented messages come out byte for byte, and on random data the
+    // checksum makes address, data and checksum add up to 0 mod 128 (plan.md)
+    // and stays a data byte
+    int checkChecksum (int iterations, juce::Random& random)
+    {
+        int failures = 0;
+        int numChecks = 0;
+
+        for (const auto* documented : documentedDataSets)
+        {
+            ++numChecks;
+
+            juce::MemoryBlock expected;
+            expected.loadFromHexString (documented);
+            const auto* bytes = static_cast<const uint8_t*> (expected.getData());
+            const auto size = expected.getSize();
+
+            // Without F0 and F7; the address starts after 41 dev 00 06 12
+            const std::vector<uint8_t> message (bytes + 1, bytes + size - 1);
+            const JP8080SysEx::Address address { message[5], message[6], message[7], message[8] };
+            const std::vector<uint8_t> addressAndData (message.begin() + 5, message.end() - 1);
+
+            if (JP8080SysEx::createDataSet (message[1], address, message.data() + 9, message.size() - 10) == message
+                 && JP8080ControllerAudioProcessor::calculateRolandChecksum (addressAndData) == message.back())
+                continue;
+
+            if (++failures <= 5)
+                std::cerr << "checksum: " << documented << " is not reproduced" << std::endl;
+        }
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            ++numChecks;
+
+            // The first case sums to 0 mod 128
+            std::vector<uint8_t> bytes (static_cast<size_t> (i == 0 ? 4 : 4 + random.nextInt (JP8080SysEx::patchSize)));
+            for (auto& byte : bytes)
+                byte = i == 0 ? 0 : static_cast<uint8_t> (random.nextInt (128));
+
+            int sum = 0;
+            for (auto byte : bytes)
+                sum += byte;
+
+            const auto checksum = JP8080ControllerAudioProcessor::calculateRolandChecksum (bytes);
+
+            if (checksum <= 0x7F && (sum + checksum) % 128 == 0)
+                continue;
+
+            if (++failures <= 5)
+                std::cerr << "checksum: " << juce::String::toHexString (bytes.data(), static_cast<int> (bytes.size()))
+                          << " -> " << juce::String::toHexString (static_cast<int> (checksum)) << std::endl;
+        }
+
+        std::cout << "checksum: " << numChecks - failures << "/" << numChecks << " passed" << std::endl;
+        return failures;
+    }
+
+    // Patch bank select values from plan.md ("Bank Select Values (for
+    // Patches)"), in patchBankNames order. Kept apart from getBankSelectInfo()
+    // so the check doesn't compare the mapping with itself.
+    struct DocumentedBank
+    {
+        const char* name;
+        int msb, lsb, firstProgram;
+    };
+
+    const DocumentedBank documentedBanks[] = {
+        { "User A",     0x50, 0x00, 0x00 },
+        { "User B",     0x50, 0x00, 0x40 },
+        { "Preset 1 A", 0x51, 0x00, 0x00 },
+        { "Preset 1 B", 0x51, 0x00, 0x40 },
+        { "Preset 2 A", 0x51, 0x01, 0x00 },
+        { "Preset 2 B", 0x51, 0x01, 0x40 },
+        { "Preset 3 A", 0x51, 0x02, 0x00 },
+        { "Preset 3 B", 0x51, 0x02, 0x40 }
+    };
+
+    // Every bank and program, in random order and on a random part, gives
+    // CC#0, CC#32 and a program change on the part's channel that match
+    // plan.md, and no two select the same patch
+    int checkBankAndProgram (juce::Random& random)
+    {
+        using namespace JP8080Parameters;
+
+        JP8080ControllerAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails (44100.0, 512);
+        processor.prepareToPlay (44100.0, 512);
+
+        auto& apvts = processor.getValueTreeState();
+        auto* partParam = apvts.getParameter (MidiConfig::part);
+        auto* bankParam = apvts.getParameter (MidiConfig::patchBank);
+        auto* programParam = apvts.getParameter (MidiConfig::patchProgram);
+
+        juce::AudioBuffer<float> buffer (2, 512);
+        juce::MidiBuffer midiMessages;
+
+        // The first blocks send the current patch and every knob
+        for (int i = 0; i < 4; ++i)
+        {
+            midiMessages.clear();
+            processor.processBlock (buffer, midiMessages);
+        }
+
+        std::vector<std::pair<int, int>> cases;
+        for (int bank = 0; bank < 8; ++bank)
+            for (int program = 1; program <= 64; ++program)
+                cases.push_back ({ bank, program });
+
+        for (size_t i = cases.size() - 1; i > 0; --i)
+            std::swap (cases[i], cases[static_cast<size_t> (random.nextInt (static_cast<int> (i) + 1))]);
+
+        std::set<std::array<int, 3>> selections;
+        int failures = 0;
+
+        for (const auto& [bank, program] : cases)
+        {
+            const int partIndex = random.nextInt (2);
+            partParam->setValueNotifyingHost (partParam->convertTo0to1 (static_cast<float> (partIndex)));
+            bankParam->setValueNotifyingHost (bankParam->convertTo0to1 (static_cast<float> (bank)));
+            programParam->setValueNotifyingHost (programParam->convertTo0to1 (static_cast<float> (program)));
+
+            midiMessages.clear();
+            processor.processBlock (buffer, midiMessages);
+
+            const int channel = partIndex == 0 ? 1 : 2;
+            int msb = -1, lsb = -1, programNumber = -1;
+
+            for (const auto metadata : midiMessages)
+            {
+                const auto message = metadata.getMessage();
+                if (message.getChannel() != channel)
+                    continue;
+
+                if (message.isControllerOfType (0))
+                    msb = message.getControllerValue();
+                else if (message.isControllerOfType (32))
+                    lsb = message.getControllerValue();
+                else if (message.isProgramChange())
+                    programNumber = message.getProgramChangeNumber();
+            }
+
+            const auto& documented = documentedBanks[bank];
+            selections.insert ({ msb, lsb, programNumber });
+
+            if (patchBankNames[bank] == documented.name
+                 && msb == documented.msb && lsb == documented.lsb && programNumber == documented.firstProgram + program - 1)
+                continue;
+
+            if (++failures <= 5)
+                std::cerr << "bank/program: " << patchBankNames[bank] << " " << program << " on channel " << channel
+                          << " -> " << msb << "/" << lsb << " PC " << programNumber << std::endl;
+        }
+
+        if (selections.size() != cases.size())
+        {
+            std::cerr << "bank/program: " << cases.size() - selections.size() << " patches share a selection" << std::endl;
+            ++failures;
+        }
+
+        processor.releaseResources();
+
+        std::cout << "bank/program: " << static_cast<int> (cases.size()) - failures << "/" << cases.size() << " passed" << std::endl;
+        return failures;
+    }
+
+    int runChecks (const juce::StringArray& args)
+    {
+        const int iterations = args.size() > 1 ? juce::jmax (1, args[1].getIntValue()) : 10000;
+        const auto seed = args.size() > 2 ? args[2].getLargeIntValue() : juce::int64 (1);
+
+        juce::Random random (seed);
+        std::cout << "seed " << seed << std::endl;
+
+        const int failures = checkChecksum (iterations, random) + checkBankAndProgram (random);
+        return failures > 0 ? 1 : 0;
+    }
+
+    //==============================================================================
+    JP8080Emulator::Settings getEmulatorSettings (const juce::StringArray& args)
+    {
+        JP8080Emulator::Settings settings;
+
+        if (args.contains ("--buffer"))
+            settings.inputBufferSize = juce::jmax (1, args[args.indexOf ("--buffer") + 1].getIntValue());
+
+        return settings;
+    }
+
+    int runEmulation (const juce::StringArray& args)
+    {
+        using namespace JP8080Parameters;
+
+        if (args.size() < 3)
+        {
+            std::cerr << "Usage: --emulate <timeline.csv> <seconds> [--buffer <bytes>]" << std::endl;
+            return 1;
+        }
+
+        constexpr double sampleRate = 44100.0;
+
+        std::vector<JP8080OfflineRenderer::AutomationPoint> timeline;
+        if (! JP8080OfflineRenderer::loadTimelineFromCSV (juce::File::getCurrentWorkingDirectory().getChildFile (args[1]), timeline))
+        {
+            std::cerr << "Could not read " << args[1] << " or a state it restores" << std::endl;
+            return 1;
+        }
+
+        // Nobody listens to the emulator here
+        auto settings = getEmulatorSettings (args);
+        settings.activeSensingIntervalMs = 0.0;
+        JP8080Emulator emulator (settings);
+
+        JP8080ControllerAudioProcessor processor;
+        JP8080OfflineRenderer renderer (processor);
+        const auto result = renderer.replay (std::move (timeline), args[2].getDoubleValue(),
+                                             [&] (juce::int64 samplePosition, const uint8_t* data, int size, bool)
+        {
+            emulator.receive (data, size, static_cast<double> (juce::jmax (juce::int64 (0), samplePosition)) / sampleRate);
+        }, sampleRate);
+
+        if (! result.ok)
+        {
+            std::cerr << result.error << std::endl;
+            return 1;
+        }
+
+        emulator.flush();
+
+        // The synth's temporary patch against the parameters, scaled as the processor sends them
+        auto& apvts = processor.getValueTreeState();
+        auto* partParam = apvts.getParameter (MidiConfig::part);
+        const int partIndex = partParam != nullptr ? juce::roundToInt (partParam->getValue()) : 0;
+        const auto patch = emulator.readMemory (JP8080SysEx::getTemporaryPatchAddress (partIndex), JP8080SysEx::patchSize);
+
+        juce::StringArray mismatches;
+
+        for (const auto& [paramID, offsetInfo] : patchOffsets)
+        {
+            auto* param = apvts.getParameter (paramID);
+            if (param == nullptr)
+                continue;
+
+            const int value = juce::roundToInt (param->convertFrom0to1 (param->getValue()));
+            const int expected = dynamic_cast<juce::AudioParameterChoice*> (param) != nullptr
+                                   ? juce::jlimit (0, offsetInfo.maxValue, value)
+                                   : juce::roundToInt (value * offsetInfo.maxValue / 127.0f);
+
+            if (patch[static_cast<size_t> (offsetInfo.offset)] != expected)
+                mismatches.add (paramID);
+        }
+
+        auto statistics = emulator.toVar();
+        statistics.getDynamicObject()->setProperty ("temporaryPatch", juce::String::toHexString (patch.data(), static_cast<int> (patch.size())));
+        statistics.getDynamicObject()->setProperty ("mismatchedParameters", mismatches.joinIntoString (","));
+
+        std::cout << juce::JSON::toString (statistics) << std::endl;
+        return mismatches.isEmpty() ? 0 : 1;
+    }
+
+    //==============================================================================
+    // The emulator on a virtual port pair, clocked by the wall clock
+    struct VirtualSynth : private juce::MidiInputCallback,
+                          private juce::HighResolutionTimer
+    {
+        explicit VirtualSynth (const JP8080Emulator::Settings& settings)
+            : emulator (settings)
+        {
+        }
+
+        ~VirtualSynth() override
+        {
+            stop();
+        }
+
+        bool start (const juce::String& name)
+        {
+            output = juce::MidiOutput::createNewDevice (name);
+            input = juce::MidiInput::createNewDevice (name, this);
+
+            if (input == nullptr || output == nullptr)
+                return false;
+
+            emulator.setOutputCallback ([this] (const uint8_t* data, int size, double)
+            {
+                output->sendMessageNow (juce::MidiMessage (data, size));
+            });
+
+            input->start();
+            startTimer (1);
+            return true;
+        }
+
+        void stop()
+        {
+            stopTimer();
+
+            if (input != nullptr)
+                input->stop();
+        }
+
+        static double now()                 { return juce::Time::getMillisecondCounterHiRes() * 0.001; }
+
+        JP8080Emulator emulator;
+
+    private:
+        void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& message) override
+        {
+            emulator.receive (message, now());
+        }
+
+        void hiResTimerCallback() override
+        {
+            emulator.advanceTo (now());
+        }
+
+        std::unique_ptr<juce::MidiInput> input;
+        std::unique_ptr<juce::MidiOutput> output;
+    };
+
+    // Polls the signal flag like ShutdownPoller
+    struct CableToggler : private juce::Timer
+    {
+        explicit CableToggler (JP8080Emulator& emulatorToUse)
+            : emulator (emulatorToUse)
+        {
+            startTimer (100);
+        }
+
+        void timerCallback() override
+        {
+            if (! cableToggleRequested.exchange (false))
+                return;
+
+            emulator.setConnected (! emulator.isConnected());
+            std::cout << (emulator.isConnected() ? "Cable connected" : "Cable pulled") << std::endl;
+        }
+
+        JP8080Emulator& emulator;
+    };
+
+    int runVirtualSynth (const juce::StringArray& args)
+    {
+        const auto name = args.size() > 1 && ! args[1].startsWith ("--") ? args[1] : juce::String ("JP-8080 Emulator");
+
+        VirtualSynth synth (getEmulatorSettings (args));
+
+        if (! synth.start (name))
+        {
+            std::cerr << "Could not create the virtual MIDI ports" << std::endl;
+            return 1;
+        }
+
+        std::signal (SIGINT, handleShutdownSignal);
+        std::signal (SIGTERM, handleShutdownSignal);
+       #ifdef SIGUSR1
+        std::signal (SIGUSR1, handleCableToggleSignal);
+       #endif
+
+        std::cout << "Serving " << name << std::endl;
+
+        ShutdownPoller shutdownPoller;
+        CableToggler cableToggler (synth.emulator);
+        juce::MessageManager::getInstance()->runDispatchLoop();
+
+        synth.stop();
+        std::cout << juce::JSON::toString (synth.emulator.toVar()) << std::endl;
+        return 0;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    if (args[0] == "--list")
+    {
+        printDevices();
+        return 0;
+    }
+
+    if (args[0] == "--output")
+        return runBridge (args);
+
+    // Offline and test modes never touch the MIDI ports, not even to look for a synth
+    const juce::StringArray offlineModes { "--benchmark", "--render", "--replay", "--check", "--emulate" };
+    if (offlineModes.contains (args[0]))
+        JP8080DeviceDiscovery::disableProbing();
+
+    if (args[0] == "--benchmark")
+        return runBenchmarks (args);
+
+    if (args[0] == "--render")
+        return runRender (args);
+
+    if (args[0] == "--replay")
+        return runReplay (args);
+
+    if (args[0] == "--check")
+        return runChecks (args);
+
+    if (args[0] == "--emulate")
+        return runEmulation (args);
+
+    if (args[0] == "--virtual-synth")
+        return runVirtualSynth (args);
+
+    std::cout << "Usage:" << std::endl
+              << "  JP8080Bridge --list" << std::endl
+              << "  JP8080Bridge --output <port> [--input <port>] [--socket <path>] [--osc <udp port>]" << std::endl
+              << "  JP8080Bridge --benchmark [seconds]" << std::endl
+              << "  JP8080Bridge --render <timeline.csv> <seconds> <out.mid> [out.syx]" << std::endl
+              << "  JP8080Bridge --replay <timeline.csv> <seconds> <golden.txt> [--update]" << std::endl
+              << "  JP8080Bridge --check [iterations] [seed]" << std::endl
+              << "  JP8080Bridge --emulate <timeline.csv> <seconds> [--buffer <bytes>]" << std::endl
+              << "  JP8080Bridge --virtual-synth [name] [--buffer <bytes>]" << std::endl;
+    return args.isEmpty() ? 0 : 1;
+}
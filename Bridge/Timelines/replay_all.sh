@@ -0,0 +1,27 @@
+#!/bin/sh
+# Replays every timeline in this directory for 2 seconds and compares the
+# output with its <name>.golden.txt. Every timeline is run; the script fails
+# if any of them differs or has no golden file yet.
+#
+# With --update the golden files are recorded instead. Record them with a
+# bridge built from before the change being checked, and commit them.
+#
+#   Bridge/Timelines/replay_all.sh <path to JP8080Bridge> [--update]
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 <path to JP8080Bridge> [--update]" >&2
+    exit 1
+fi
+
+bridge="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+shift
+
+cd "$(dirname "$0")" || exit 1
+
+status=0
+
+for timeline in *.csv; do
+    "$bridge" --replay "$timeline" 2 "${timeline%.csv}.golden.txt" "$@" || status=1
+done
+
+exit $status
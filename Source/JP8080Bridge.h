@@ -0,0 +1,355 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+/**
+ * Headless MIDI bridge: runs the controller engine without a DAW
+ *
+ * Hosts the processor on a high-resolution timer thread with a 1 ms tick and
+ * sends each tick's output straight to the processor's MIDI output (ALSA on
+ * Linux). Parameters are driven from a controller MIDI port, where incoming
+ * CCs follow the processor's MIDI learn routes or are mapped back to the
+ * parameters that transmit them, and from a UNIX datagram socket speaking a
+ * compact binary protocol of 4-byte commands:
+ *
+ *   01 index value 00     Set parameter (processor index, value 0-127 or choice index)
+ *   02 bank patch 00      Select patch (bank 0-7, patch 1-64)
+ *   03 status data data   Pass a short MIDI message through to the synth
+ *
+ * A datagram may carry any number of commands.
+ */
+class JP8080Bridge : private juce::HighResolutionTimer,
+                     private juce::MidiInputCallback,
+                     private juce::Thread
+{
+public:
+    static constexpr int tickIntervalMs = 1;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int samplesPerTick = 48;
+    static constexpr int commandSize = 4;
+
+    enum Command : uint8_t
+    {
+        setParameter = 0x01,
+        selectPatch = 0x02,
+        sendMidi = 0x03
+    };
+
+    explicit JP8080Bridge (JP8080ControllerAudioProcessor& processorToHost)
+        : juce::Thread ("JP-8080 Bridge Socket"),
+          processor (processorToHost)
+    {
+        // Indexed like the transmit map, so a CC finds its knob parameter
+        for (const auto& paramID : JP8080Parameters::getAllParameterIDs())
+            knobParameters.push_back (processor.getValueTreeState().getParameter (paramID));
+    }
+
+    ~JP8080Bridge() override
+    {
+        stop();
+    }
+
+    //==============================================================================
+    // Either source may be empty. Fails if the controller port or the socket can't be opened.
+    bool start (const juce::String& controllerInputId, const juce::String& socketPath)
+    {
+        stop();
+
+        processor.setRateAndBufferSizeDetails (sampleRate, samplesPerTick);
+        processor.prepareToPlay (sampleRate, samplesPerTick);
+        processor.setPlayHead (&playHead);
+
+        if (controllerInputId.isNotEmpty())
+        {
+            controllerInput = juce::MidiInput::openDevice (controllerInputId, this);
+
+            if (controllerInput == nullptr)
+                return false;
+
+            controllerInput->start();
+        }
+
+        if (socketPath.isNotEmpty())
+        {
+            if (! openSocket (socketPath))
+                return false;
+
+            startThread();
+        }
+
+        startTimer (tickIntervalMs);
+        return true;
+    }
+
+    void stop()
+    {
+        stopTimer();
+        stopThread (1000);
+        closeSocket();
+
+        if (controllerInput != nullptr)
+        {
+            controllerInput->stop();
+            controllerInput.reset();
+        }
+
+        processor.setPlayHead (nullptr);
+    }
+
+    //==============================================================================
+    // Applies a buffer of protocol commands, returns the number applied.
+    // Any thread: parameter changes are picked up by the next tick.
+    int handleCommands (const uint8_t* data, int size)
+    {
+        int numApplied = 0;
+
+        for (int offset = 0; offset + commandSize <= size; offset += commandSize)
+        {
+            const auto* command = data + offset;
+
+            switch (command[0])
+            {
+                case setParameter:
+                {
+                    const auto& parameters = processor.getParameters();
+
+                    if (command[1] >= parameters.size())
+                        continue;
+
+                    if (auto* param = dynamic_cast<juce::RangedAudioParameter*> (parameters[command[1]]))
+                        param->setValueNotifyingHost (param->convertTo0to1 (static_cast<float> (command[2])));
+
+                    break;
+                }
+
+                case selectPatch:
+                {
+                    auto& apvts = processor.getValueTreeState();
+                    auto* bankParam = apvts.getParameter (JP8080Parameters::MidiConfig::patchBank);
+                    auto* programParam = apvts.getParameter (JP8080Parameters::MidiConfig::patchProgram);
+
+                    if (bankParam == nullptr || programParam == nullptr)
+                        continue;
+
+                    bankParam->setValueNotifyingHost (bankParam->convertTo0to1 (static_cast<float> (command[1])));
+                    programParam->setValueNotifyingHost (programParam->convertTo0to1 (static_cast<float> (command[2])));
+                    break;
+                }
+
+                case sendMidi:
+                    if (! queuePassThrough (command + 1, juce::MidiMessage::getMessageLengthFromFirstByte (command[1])))
+                        continue;
+
+                    break;
+
+                default:
+                    continue;
+            }
+
+            ++numApplied;
+        }
+
+        return numApplied;
+    }
+
+private:
+    //==============================================================================
+    // Reports a running transport, so the trace carries sample positions
+    struct BridgePlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setTimeInSamples (timeInSamples);
+            info.setIsPlaying (true);
+            return info;
+        }
+
+        juce::int64 timeInSamples = 0;
+    };
+
+    // Timer thread
+    void hiResTimerCallback() override
+    {
+        midiMessages.clear();
+        drainPassThrough();
+
+        playHead.timeInSamples = position;
+        processor.processBlock (buffer, midiMessages);
+        processor.sendMidiBufferDirect (midiMessages);
+
+        position += samplesPerTick;
+    }
+
+    // Controller MIDI thread
+    void handleIncomingMidiMessage (juce::MidiInput*, const juce::MidiMessage& message) override
+    {
+        if (message.isController())
+        {
+            const int ccNumber = message.getControllerNumber();
+            auto& midiLearn = processor.getMidiLearn();
+
+            // Learned routes, and arming a parameter for learning, take the CC first
+            if (midiLearn.handleControlChange (message.getChannel(), ccNumber, message.getControllerValue()))
+                return;
+
+            // Otherwise the CC drives whichever knob this instance transmits it for
+            for (size_t knobIndex = 0; knobIndex < knobParameters.size(); ++knobIndex)
+            {
+                auto* param = knobParameters[knobIndex];
+
+                if (param != nullptr && midiLearn.getTransmitCC (static_cast<int> (knobIndex)) == ccNumber)
+                {
+                    param->setValueNotifyingHost (param->convertTo0to1 (static_cast<float> (message.getControllerValue())));
+                    return;
+                }
+            }
+        }
+
+        // Notes, bend etc. go through to the synth; SysEx and realtime don't
+        if (message.getRawDataSize() <= 3 && ! message.isSysEx() && message.getRawData()[0] < 0xF0)
+            queuePassThrough (message.getRawData(), message.getRawDataSize());
+    }
+
+    //==============================================================================
+    // Short messages queued for the next tick's MidiBuffer, which the
+    // processor passes through to its output
+    struct ShortMessage
+    {
+        std::array<uint8_t, 3> bytes;
+        int size;
+    };
+
+    // Controller MIDI thread and socket thread
+    bool queuePassThrough (const uint8_t* data, int size)
+    {
+        if (size < 1 || size > 3 || (data[0] & 0x80) == 0)
+            return false;
+
+        const juce::SpinLock::ScopedLockType sl (passThroughWriteLock);
+        const auto scope = passThroughFifo.write (1);
+
+        if (scope.blockSize1 < 1)
+            return false;
+
+        auto& slot = passThroughBuffer[static_cast<size_t> (scope.startIndex1)];
+        std::copy (data, data + size, slot.bytes.begin());
+        slot.size = size;
+        return true;
+    }
+
+    // Timer thread
+    void drainPassThrough()
+    {
+        const auto scope = passThroughFifo.read (passThroughFifo.getNumReady());
+
+        auto addRange = [this] (int start, int count)
+        {
+            for (int i = start; i < start + count; ++i)
+            {
+                const auto& slot = passThroughBuffer[static_cast<size_t> (i)];
+                midiMessages.addEvent (slot.bytes.data(), slot.size, 0);
+            }
+        };
+
+        addRange (scope.startIndex1, scope.blockSize1);
+        addRange (scope.startIndex2, scope.blockSize2);
+    }
+
+    //==============================================================================
+    bool openSocket (const juce::String& socketPath)
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+
+        if (socketPath.getNumBytesAsUTF8() >= sizeof (address.sun_path))
+            return false;
+
+        socketPath.copyToUTF8 (address.sun_path, sizeof (address.sun_path));
+        ::unlink (address.sun_path);
+
+        socketHandle = ::socket (AF_UNIX, SOCK_DGRAM, 0);
+
+        if (socketHandle < 0)
+            return false;
+
+        if (::bind (socketHandle, reinterpret_cast<sockaddr*> (&address), sizeof (address)) != 0)
+        {
+            closeSocket();
+            return false;
+        }
+
+        boundSocketPath = socketPath;
+        return true;
+       #else
+        juce::ignoreUnused (socketPath);
+        return false;
+       #endif
+    }
+
+    void closeSocket()
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        if (socketHandle >= 0)
+            ::close (socketHandle);
+
+        if (boundSocketPath.isNotEmpty())
+            ::unlink (boundSocketPath.toRawUTF8());
+       #endif
+
+        socketHandle = -1;
+        boundSocketPath.clear();
+    }
+
+    // Socket thread
+    void run() override
+    {
+       #if JUCE_LINUX || JUCE_MAC
+        std::array<uint8_t, 4096> datagram;
+
+        while (! threadShouldExit())
+        {
+            pollfd descriptor { socketHandle, POLLIN, 0 };
+
+            // Wake up regularly to check for shutdown
+            if (::poll (&descriptor, 1, 100) <= 0)
+                continue;
+
+            const auto received = ::recv (socketHandle, datagram.data(), datagram.size(), 0);
+
+            if (received > 0)
+                handleCommands (datagram.data(), static_cast<int> (received));
+        }
+       #endif
+    }
+
+    //==============================================================================
+    JP8080ControllerAudioProcessor& processor;
+    std::vector<juce::RangedAudioParameter*> knobParameters;
+
+    std::unique_ptr<juce::MidiInput> controllerInput;
+    int socketHandle = -1;
+    juce::String boundSocketPath;
+
+    // Timer thread only
+    BridgePlayHead playHead;
+    juce::int64 position = 0;
+    juce::AudioBuffer<float> buffer { 2, samplesPerTick };
+    juce::MidiBuffer midiMessages;
+
+    juce::AbstractFifo passThroughFifo { 256 };
+    std::array<ShortMessage, 256> passThroughBuffer {};
+    juce::SpinLock passThroughWriteLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080Bridge)
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * Background backup and restore of the JP-8080 user memory
+ *
+ * Backup requests every user patch and performance with RQ1 and streams the
+ * DT1 replies into a .syx file. Restore sends the DT1 messages of a .syx file
+ * back, paced by the wire time of each message plus the gap the JP-8080 needs
+ * to process it. Runs on its own thread; the MIDI input thread feeds replies
+ * through handleIncomingDataSet().
+ */
+class JP8080BulkTransfer : private juce::Thread
+{
+public:
+    // Sends a SysEx body (without F0/F7) to the hardware
+    using SendFunction = std::function<void (const std::vector<uint8_t>&)>;
+
+    explicit JP8080BulkTransfer (SendFunction sendFunction)
+        : juce::Thread ("JP-8080 Bulk Transfer"), send (std::move (sendFunction))
+    {
+    }
+
+    ~JP8080BulkTransfer() override
+    {
+        stop();
+    }
+
+    //==============================================================================
+    bool startBackup (const juce::File& destination, uint8_t deviceId)
+    {
+        return start (Mode::backup, destination, deviceId);
+    }
+
+    bool startRestore (const juce::File& source, uint8_t deviceId)
+    {
+        return start (Mode::restore, source, deviceId);
+    }
+
+    void cancel()                           { signalThreadShouldExit(); replyReceived.signal(); }
+    void stop()                             { cancel(); stopThread (4000); }
+    bool isRunning() const                  { return isThreadRunning(); }
+    double getProgress() const              { return progress.load(); }
+
+    juce::String getStatusText() const
+    {
+        const juce::ScopedLock sl (statusLock);
+        return statusText;
+    }
+
+    //==============================================================================
+    // Called from the MIDI input thread for each validated DT1.
+    // sysexData is the message body without F0/F7.
+    void handleIncomingDataSet (const JP8080SysEx::DataSet& dataSet, const uint8_t* sysexData, int sysexSize)
+    {
+        if (mode != Mode::backup || ! isThreadRunning())
+            return;
+
+        const juce::ScopedLock sl (replyLock);
+        const int address = JP8080SysEx::addressToInt (dataSet.address);
+
+        // Only keep replies that belong to the outstanding request
+        if (address < requestStart || address >= requestStart + requestSize)
+            return;
+
+        // Capacity is reserved up front, so appending doesn't allocate
+        pendingReplies.push_back (0xF0);
+        pendingReplies.insert (pendingReplies.end(), sysexData, sysexData + sysexSize);
+        pendingReplies.push_back (0xF7);
+
+        receivedBytes += dataSet.size;
+
+        if (receivedBytes >= requestSize)
+            replyReceived.signal();
+    }
+
+private:
+    enum class Mode
+    {
+        idle,
+        backup,
+        restore
+    };
+
+    static constexpr int replyTimeoutMs = 1000;
+    static constexpr int messageIntervalMs = 20;        // Gap the JP-8080 needs between DT1 messages
+    static constexpr double wireBytesPerMs = 3.125;     // 31.25 kbit/s, 10 bits per byte
+    static constexpr size_t maxPendingReplySize = 2048; // Largest request (one patch) split over several DT1s
+
+    bool start (Mode newMode, const juce::File& file, uint8_t newDeviceId)
+    {
+        if (isThreadRunning())
+            return false;
+
+        mode = newMode;
+        transferFile = file;
+        deviceId = newDeviceId;
+        progress = 0.0;
+        setStatusText ({});
+
+        {
+            const juce::ScopedLock sl (replyLock);
+            pendingReplies.clear();
+            pendingReplies.reserve (maxPendingReplySize);
+        }
+
+        return startThread();
+    }
+
+    void run() override
+    {
+        if (mode == Mode::backup)
+            runBackup();
+        else if (mode == Mode::restore)
+            runRestore();
+
+        mode = Mode::idle;
+    }
+
+    //==============================================================================
+    void runBackup()
+    {
+        using namespace JP8080SysEx;
+
+        struct Request
+        {
+            Address address;
+            int size;
+        };
+
+        std::vector<Request> requests;
+
+        for (int patchIndex = 0; patchIndex < numUserPatches; ++patchIndex)
+            requests.push_back ({ getUserPatchAddress (patchIndex), patchSize });
+
+        for (int performanceIndex = 0; performanceIndex < numUserPerformances; ++performanceIndex)
+        {
+            const int base = addressToInt (getUserPerformanceAddress (performanceIndex));
+
+            for (const auto& block : performanceBlocks)
+                requests.push_back ({ intToAddress (base + block.offset), block.size });
+        }
+
+        juce::TemporaryFile tempFile (transferFile);
+        int missingReplies = 0;
+        bool writeFailed = false;
+
+        {
+            juce::FileOutputStream stream (tempFile.getFile());
+
+            if (! stream.openedOk())
+            {
+                setStatusText ("Could not write " + transferFile.getFileName());
+                return;
+            }
+
+            for (size_t i = 0; i < requests.size() && ! threadShouldExit(); ++i)
+            {
+                {
+                    const juce::ScopedLock sl (replyLock);
+                    requestStart = addressToInt (requests[i].address);
+                    requestSize = requests[i].size;
+                    receivedBytes = 0;
+                    replyReceived.reset();
+                }
+
+                send (createDataRequest (deviceId, requests[i].address, requests[i].size));
+
+                if (! replyReceived.wait (replyTimeoutMs))
+                    ++missingReplies;
+
+                // Stream whatever arrived for this request into the file
+                {
+                    const juce::ScopedLock sl (replyLock);
+                    stream.write (pendingReplies.data(), pendingReplies.size());
+                    pendingReplies.clear();
+                    requestSize = 0;
+                }
+
+                progress = static_cast<double> (i + 1) / static_cast<double> (requests.size());
+                wait (messageIntervalMs);
+            }
+
+            stream.flush();
+            writeFailed = stream.getStatus().failed();
+        }
+
+        if (threadShouldExit())
+        {
+            setStatusText ("Backup cancelled");
+            return;
+        }
+
+        if (writeFailed || ! tempFile.overwriteTargetFileWithTemporary())
+        {
+            setStatusText ("Could not write " + transferFile.getFileName());
+            return;
+        }
+
+        setStatusText (missingReplies == 0 ? "Backup complete"
+                                           : "Backup complete, " + juce::String (missingReplies) + " blocks missing");
+    }
+
+    //==============================================================================
+    void runRestore()
+    {
+        juce::MemoryBlock fileData;
+
+        if (! transferFile.loadFileAsData (fileData))
+        {
+            setStatusText ("Could not read " + transferFile.getFileName());
+            return;
+        }
+
+        auto* bytes = static_cast<const uint8_t*> (fileData.getData());
+        const int totalSize = static_cast<int> (fileData.getSize());
+        int sentMessages = 0;
+
+        for (int pos = 0; pos < totalSize && ! threadShouldExit();)
+        {
+            // Find the next complete F0 ... F7 message
+            if (bytes[pos] != 0xF0)
+            {
+                ++pos;
+                continue;
+            }
+
+            int end = pos + 1;
+            while (end < totalSize && bytes[end] != 0xF7)
+                ++end;
+
+            if (end >= totalSize)
+                break;
+
+            std::vector<uint8_t> body (bytes + pos + 1, bytes + end);
+            pos = end + 1;
+
+            // Only JP-8080 DT1 messages are restored, addressed to the current device ID
+            JP8080SysEx::DataSet dataSet;
+            if (! JP8080SysEx::parseDataSet (body.data(), static_cast<int> (body.size()), dataSet))
+                continue;
+
+            body[1] = deviceId;
+            send (body);
+            ++sentMessages;
+
+            progress = static_cast<double> (pos) / static_cast<double> (totalSize);
+
+            // Wait for the message to leave the wire, then give the synth time to store it
+            wait (juce::roundToInt ((body.size() + 2) / wireBytesPerMs) + messageIntervalMs);
+        }
+
+        if (threadShouldExit())
+            setStatusText ("Restore cancelled");
+        else
+            setStatusText ("Restored " + juce::String (sentMessages) + " blocks");
+
+        progress = 1.0;
+    }
+
+    void setStatusText (const juce::String& newText)
+    {
+        const juce::ScopedLock sl (statusLock);
+        statusText = newText;
+    }
+
+    //==============================================================================
+    SendFunction send;
+    std::atomic<Mode> mode { Mode::idle };
+    juce::File transferFile;
+    uint8_t deviceId = JP8080SysEx::defaultDeviceId;
+    std::atomic<double> progress { 0.0 };
+
+    juce::CriticalSection statusLock;
+    juce::String statusText;
+
+    // Outstanding backup request, guarded by replyLock
+    juce::CriticalSection replyLock;
+    int requestStart = 0;
+    int requestSize = 0;
+    int receivedBytes = 0;
+    std::vector<uint8_t> pendingReplies;
+    juce::WaitableEvent replyReceived;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080BulkTransfer)
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * Encodes a burst of parameter changes on one part for the fewest bytes on the wire
+ *
+ * Each control change leaves the plugin as a full three-byte message (the
+ * host's MidiBuffer has no running status), so that is what it is costed at.
+ * Changes that sit close together in the patch image can instead go out as
+ * one DT1 to the temporary patch (12 bytes of framing plus one per data
+ * byte), as long as every byte in between is known. The compiler groups the
+ * patch offsets into such runs and, run by run, keeps whichever form is
+ * shorter. Changes without a patch address are always CCs, changes without
+ * a CC number always DT1. When DT1 can't be delivered, compile CCs only.
+ *
+ * The CC bytes are stored compactly with running status for channel 1 (status
+ * B0H); the sender expands them and puts in the channel, so a compiled burst
+ * can be reused on either part. prepare() reserves everything compile() needs,
+ * so compiling on the audio thread doesn't allocate.
+ */
+class JP8080BurstCompiler
+{
+public:
+    struct Change
+    {
+        int ccNumber;       // -1: not a CC parameter
+        int ccValue;
+        int patchOffset;    // -1: not stored in the patch
+        int patchValue;
+    };
+
+    // Patch bytes around the changes, -1 where unknown
+    using KnownPatchBytes = std::array<int16_t, JP8080SysEx::patchSize>;
+
+    struct Burst
+    {
+        std::vector<uint8_t> controlChanges;            // Running status, channel 1
+        std::vector<std::vector<uint8_t>> dataSets;     // DT1 messages without F0/F7; the first numDataSets are used
+        int numDataSets = 0;
+
+        // Message thread, before compiling on the audio thread
+        void prepare()
+        {
+            controlChanges.reserve (1 + 2 * JP8080SysEx::patchSize);
+            pendingControlChanges.reserve (JP8080SysEx::patchSize);
+            runData.reserve (JP8080SysEx::patchSize);
+
+            // Every run holds at least one change, so there are at most patchSize of them
+            dataSets.resize (JP8080SysEx::patchSize);
+            for (auto& dataSet : dataSets)
+                dataSet.reserve (static_cast<size_t> (dataSetOverhead + JP8080SysEx::patchSize));
+        }
+
+        void clear()
+        {
+            controlChanges.clear();
+            numDataSets = 0;
+        }
+
+        bool isEmpty() const                { return controlChanges.empty() && numDataSets == 0; }
+
+        int getNumControlChanges() const    { return static_cast<int> (controlChanges.size()) / 2; }
+
+        // Bytes on the wire, F0/F7 included
+        int getWireBytes() const
+        {
+            int bytes = getNumControlChanges() * controlChangeBytes;
+            for (int i = 0; i < numDataSets; ++i)
+                bytes += static_cast<int> (dataSets[static_cast<size_t> (i)].size()) + 2;
+
+            return bytes;
+        }
+
+    private:
+        friend class JP8080BurstCompiler;
+
+        std::vector<Change> pendingControlChanges;
+        std::vector<uint8_t> runData;
+    };
+
+    static constexpr int dataSetOverhead = 12;      // F0 41 dev 00 06 12, 4 address bytes, checksum, F7
+    static constexpr int controlChangeBytes = 3;    // Status, controller, value
+
+    //==============================================================================
+    // CCs only, with running status
+    static void encodeControlChanges (const std::vector<Change>& changes, std::vector<uint8_t>& bytes)
+    {
+        bytes.clear();
+
+        for (const auto& change : changes)
+        {
+            if (change.ccNumber < 0)
+                continue;
+
+            if (bytes.empty())
+                bytes.push_back (0xB0);
+
+            bytes.push_back (static_cast<uint8_t> (juce::jlimit (0, 127, change.ccNumber)));
+            bytes.push_back (static_cast<uint8_t> (juce::jlimit (0, 127, change.ccValue)));
+        }
+    }
+
+    // Chooses CC or DT1 for each run of nearby patch offsets. Without
+    // allowDataSets every change is a CC and DT1-only changes are left out.
+    static void compile (const std::vector<Change>& changes, int partIndex, uint8_t deviceId,
+                         const KnownPatchBytes& knownBytes, bool allowDataSets, Burst& burst)
+    {
+        burst.clear();
+
+        // Offset -> index of the change, in patch order
+        std::array<int16_t, JP8080SysEx::patchSize> changeAtOffset;
+        changeAtOffset.fill (-1);
+
+        auto& controlChanges = burst.pendingControlChanges;
+        controlChanges.clear();
+
+        for (size_t i = 0; i < changes.size(); ++i)
+        {
+            const auto& change = changes[i];
+
+            if (allowDataSets && juce::isPositiveAndBelow (change.patchOffset, JP8080SysEx::patchSize))
+                changeAtOffset[static_cast<size_t> (change.patchOffset)] = static_cast<int16_t> (i);
+            else if (change.ccNumber >= 0)
+                controlChanges.push_back (change);
+        }
+
+        int offset = 0;
+
+        while (offset < JP8080SysEx::patchSize)
+        {
+            if (changeAtOffset[static_cast<size_t> (offset)] < 0)
+            {
+                ++offset;
+                continue;
+            }
+
+            // Grow the run while bridging the gap to the next change is cheaper than a new message
+            const int runStart = offset;
+            int runEnd = offset + 1;
+            int numInRun = 1;
+            bool runHasDT1Only = changes[static_cast<size_t> (changeAtOffset[static_cast<size_t> (offset)])].ccNumber < 0;
+
+            for (;;)
+            {
+                int next = runEnd;
+                bool gapKnown = true;
+
+                while (next < JP8080SysEx::patchSize && changeAtOffset[static_cast<size_t> (next)] < 0)
+                {
+                    gapKnown = gapKnown && knownBytes[static_cast<size_t> (next)] >= 0;
+                    ++next;
+                }
+
+                if (next >= JP8080SysEx::patchSize || ! gapKnown || next - runEnd >= dataSetOverhead)
+                    break;
+
+                runEnd = next + 1;
+                ++numInRun;
+                runHasDT1Only = runHasDT1Only || changes[static_cast<size_t> (changeAtOffset[static_cast<size_t> (next)])].ccNumber < 0;
+            }
+
+            const int dataSetBytes = dataSetOverhead + (runEnd - runStart);
+            const int ccBytes = numInRun * controlChangeBytes;
+
+            if (runHasDT1Only || dataSetBytes < ccBytes)
+            {
+                addDataSet (changes, changeAtOffset, knownBytes, runStart, runEnd, partIndex, deviceId, burst);
+            }
+            else
+            {
+                for (int i = runStart; i < runEnd; ++i)
+                    if (changeAtOffset[static_cast<size_t> (i)] >= 0)
+                        controlChanges.push_back (changes[static_cast<size_t> (changeAtOffset[static_cast<size_t> (i)])]);
+            }
+
+            offset = runEnd;
+        }
+
+        encodeControlChanges (controlChanges, burst.controlChanges);
+    }
+
+private:
+    static void addDataSet (const std::vector<Change>& changes,
+                            const std::array<int16_t, JP8080SysEx::patchSize>& changeAtOffset,
+                            const KnownPatchBytes& knownBytes, int runStart, int runEnd,
+                            int partIndex, uint8_t deviceId, Burst& burst)
+    {
+        auto& data = burst.runData;
+        data.clear();
+
+        for (int i = runStart; i < runEnd; ++i)
+        {
+            const int changeIndex = changeAtOffset[static_cast<size_t> (i)];
+            const int value = changeIndex >= 0 ? changes[static_cast<size_t> (changeIndex)].patchValue
+                                               : knownBytes[static_cast<size_t> (i)];
+            data.push_back (static_cast<uint8_t> (juce::jlimit (0, 127, value)));
+        }
+
+        // Unprepared bursts (not on the audio thread) grow the pool
+        if (burst.numDataSets >= static_cast<int> (burst.dataSets.size()))
+            burst.dataSets.emplace_back();
+
+        const auto address = JP8080SysEx::intToAddress (JP8080SysEx::addressToInt (JP8080SysEx::getTemporaryPatchAddress (partIndex))
+                                                        + runStart);
+        JP8080SysEx::writeDataSet (deviceId, address, data.data(), data.size(),
+                                   burst.dataSets[static_cast<size_t> (burst.numDataSets++)]);
+    }
+};
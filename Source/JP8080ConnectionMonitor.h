@@ -0,0 +1,149 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * Hardware connection health monitor
+ *
+ * Tracks Active Sensing (FE) from the JP-8080 on the input thread and pings
+ * the synth with a one-byte RQ1 to measure round-trip latency. Follows the
+ * MIDI spec for Active Sensing: silence is only treated as a dropped link
+ * once FE has been seen on the port. A ping without a reply only makes the
+ * latency unknown, as the input may be a keyboard, or the synth's SysEx Rx
+ * may be off or set to another device ID.
+ */
+class JP8080ConnectionMonitor : private juce::Timer
+{
+public:
+    enum class State
+    {
+        unknown,        // No input/output pair selected yet
+        connected,
+        disconnected    // Active Sensing seen, then stopped
+    };
+
+    // Sends a SysEx body (without F0/F7) to the hardware
+    using SendFunction = std::function<void (const std::vector<uint8_t>&)>;
+
+    explicit JP8080ConnectionMonitor (SendFunction sendFunction)
+        : send (std::move (sendFunction))
+    {
+    }
+
+    ~JP8080ConnectionMonitor() override
+    {
+        stopTimer();
+    }
+
+    // Called on the message thread when a dropped link comes back
+    std::function<void()> onReconnected;
+
+    //==============================================================================
+    // Start or stop monitoring (when the input/output pair changes)
+    void setEnabled (bool shouldBeEnabled, uint8_t newDeviceId)
+    {
+        deviceId = newDeviceId;
+        activeSensingSeen = false;
+        lastActivityTime = 0;
+        pingSentTime = 0;
+        lastPingTime = 0;
+
+        if (shouldBeEnabled)
+        {
+            setState (State::connected);
+            startTimer (checkIntervalMs);
+        }
+        else
+        {
+            stopTimer();
+            setState (State::unknown);
+        }
+    }
+
+    State getState() const                      { return state.load(); }
+    bool isDisconnected() const                 { return state.load() == State::disconnected; }
+
+    // Last measured RQ1 round trip in milliseconds, or -1 if none yet or the last ping went unanswered
+    int getRoundTripMs() const                  { return roundTripMs.load(); }
+
+    //==============================================================================
+    // Input thread: called for every incoming message
+    void noteIncomingMessage (bool isActiveSense)
+    {
+        lastActivityTime = juce::Time::getMillisecondCounter();
+
+        if (isActiveSense)
+            activeSensingSeen = true;
+    }
+
+    // Input thread: called for every validated DT1
+    void handleDataSet (const JP8080SysEx::DataSet& dataSet)
+    {
+        const auto sentTime = pingSentTime.load();
+
+        if (sentTime == 0 || dataSet.address != pingAddress)
+            return;
+
+        const auto now = juce::Time::getMillisecondCounter();
+        roundTripMs = static_cast<int> (now - sentTime);
+        pingSentTime = 0;
+    }
+
+private:
+    static constexpr int checkIntervalMs = 100;
+    static constexpr juce::uint32 activeSensingTimeoutMs = 400;   // FE every ~200 ms
+    static constexpr juce::uint32 pingIntervalMs = 1000;
+    static constexpr juce::uint32 pingTimeoutMs = 3 * pingIntervalMs;
+
+    // First byte of System Common: small, always readable
+    static constexpr JP8080SysEx::Address pingAddress { 0x00, 0x00, 0x00, 0x00 };
+
+    void timerCallback() override
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+
+        // Ping for latency, and as the liveness check when Active Sensing is off
+        if (now - lastPingTime >= pingIntervalMs)
+        {
+            lastPingTime = now;
+
+            if (pingSentTime.load() == 0)
+                pingSentTime = now;
+
+            send (JP8080SysEx::createDataRequest (deviceId, pingAddress, 1));
+        }
+
+        // Unanswered: the latency is unknown until a later ping gets a reply
+        const auto sentTime = pingSentTime.load();
+        if (sentTime != 0 && (now - sentTime) > pingTimeoutMs)
+        {
+            pingSentTime = 0;
+            roundTripMs = -1;
+        }
+
+        const bool alive = ! activeSensingSeen || (now - lastActivityTime.load()) <= activeSensingTimeoutMs;
+        setState (alive ? State::connected : State::disconnected);
+    }
+
+    void setState (State newState)
+    {
+        const auto oldState = state.exchange (newState);
+
+        if (oldState == State::disconnected && newState == State::connected && onReconnected != nullptr)
+            onReconnected();
+    }
+
+    SendFunction send;
+    uint8_t deviceId = JP8080SysEx::defaultDeviceId;
+    std::atomic<State> state { State::unknown };
+
+    std::atomic<bool> activeSensingSeen { false };
+    std::atomic<juce::uint32> lastActivityTime { 0 };
+    std::atomic<juce::uint32> pingSentTime { 0 };       // 0 = no ping outstanding
+    juce::uint32 lastPingTime = 0;
+    std::atomic<int> roundTripMs { -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080ConnectionMonitor)
+};
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * Background discovery of JP-8080 units across all MIDI ports
+ *
+ * Keeps a cached copy of the MIDI device lists so the UI never has to query
+ * the OS, and probes outputs that appear (hot-plug, renamed ports) or all of
+ * them on rescan(). A probe sends the universal Identity Request to one
+ * output at a time and pairs it with the inputs a JP-8080 answers on, so
+ * other gear only ever sees a standard inquiry. Ports a plugin instance in
+ * this process has open are left alone; the synths found on them earlier are
+ * kept. Shared between plugin instances; listeners are notified on the
+ * message thread.
+ */
+class JP8080DeviceDiscovery : public juce::ChangeBroadcaster,
+                              private juce::Thread,
+                              private juce::MidiInputCallback
+{
+public:
+    // A JP-8080 reachable through an output/input pair
+    struct Synth
+    {
+        juce::MidiDeviceInfo output;
+        juce::MidiDeviceInfo input;
+        uint8_t deviceId = JP8080SysEx::defaultDeviceId;
+    };
+
+    JP8080DeviceDiscovery()
+        : juce::Thread ("JP-8080 Discovery")
+    {
+        // Initial device lists, so they are available before the first poll
+        cachedOutputs = juce::MidiOutput::getAvailableDevices();
+        cachedInputs = juce::MidiInput::getAvailableDevices();
+
+        if (probingEnabled)
+            startThread();
+    }
+
+    ~JP8080DeviceDiscovery() override
+    {
+        stopThread (4000);
+    }
+
+    // Process-wide. Offline tools call this before creating the first processor,
+    // so nothing is sent to the MIDI ports and the device lists stay as they were.
+    static void disableProbing()                    { probingEnabled = false; }
+
+    //==============================================================================
+    juce::Array<juce::MidiDeviceInfo> getOutputs() const
+    {
+        const juce::ScopedLock sl (resultLock);
+        return cachedOutputs;
+    }
+
+    juce::Array<juce::MidiDeviceInfo> getInputs() const
+    {
+        const juce::ScopedLock sl (resultLock);
+        return cachedInputs;
+    }
+
+    std::vector<Synth> getSynths() const
+    {
+        const juce::ScopedLock sl (resultLock);
+        return synths;
+    }
+
+    // Incremented whenever the cached lists or synths change
+    int getGeneration() const                       { return generation.load(); }
+
+    // Probe every port again now (e.g. after the user power-cycled the synth)
+    void rescan()
+    {
+        rescanRequested = true;
+        notify();
+    }
+
+    // Message thread. The ports an instance has open, left out of probes; empty when it closes.
+    void setPortsInUse (const void* owner, const juce::String& outputId, const juce::String& inputId)
+    {
+        const juce::ScopedLock sl (resultLock);
+
+        if (outputId.isEmpty() && inputId.isEmpty())
+            portsInUse.erase (owner);
+        else
+            portsInUse[owner] = juce::StringArray (outputId, inputId);
+    }
+
+private:
+    static constexpr int pollIntervalMs = 2000;
+    static constexpr int replyTimeoutMs = 300;
+
+    static inline std::atomic<bool> probingEnabled { true };
+
+    //==============================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            auto outputs = juce::MidiOutput::getAvailableDevices();
+            auto inputs = juce::MidiInput::getAvailableDevices();
+            bool listsChanged = false;
+
+            {
+                const juce::ScopedLock sl (resultLock);
+
+                if (outputs != cachedOutputs || inputs != cachedInputs)
+                {
+                    cachedOutputs = outputs;
+                    cachedInputs = inputs;
+                    listsChanged = true;
+                    ++generation;
+                    sendChangeMessage();
+                }
+            }
+
+            if (rescanRequested.exchange (false))
+                probedOutputs.clear();
+
+            // Only outputs not probed before: new ports, or all of them after a rescan
+            bool probeNeeded = listsChanged;
+            for (const auto& info : outputs)
+                probeNeeded = probeNeeded || ! probedOutputs.contains (info.identifier);
+
+            if (probeNeeded)
+                probe (outputs, inputs);
+
+            wait (pollIntervalMs);
+        }
+    }
+
+    void probe (const juce::Array<juce::MidiDeviceInfo>& outputs, const juce::Array<juce::MidiDeviceInfo>& inputs)
+    {
+        juce::StringArray inUse;
+        std::vector<Synth> previousSynths;
+        {
+            const juce::ScopedLock sl (resultLock);
+
+            for (const auto& [owner, ports] : portsInUse)
+                inUse.addArray (ports);
+
+            previousSynths = synths;
+        }
+
+        auto isPresent = [] (const juce::Array<juce::MidiDeviceInfo>& devices, const juce::MidiDeviceInfo& info)
+        {
+            return devices.contains (info);
+        };
+
+        // Synths on outputs that aren't probed this time stay as they were, if their ports are still there
+        std::vector<Synth> found;
+        std::vector<juce::MidiDeviceInfo> outputsToProbe;
+
+        for (const auto& info : outputs)
+        {
+            if (! inUse.contains (info.identifier) && ! probedOutputs.contains (info.identifier))
+                outputsToProbe.push_back (info);
+        }
+
+        for (const auto& synth : previousSynths)
+        {
+            const bool reprobed = std::find (outputsToProbe.begin(), outputsToProbe.end(), synth.output) != outputsToProbe.end();
+
+            if (! reprobed && isPresent (outputs, synth.output) && isPresent (inputs, synth.input))
+                found.push_back (synth);
+        }
+
+        if (! outputsToProbe.empty())
+        {
+            // Listen on every input nobody in this process has open
+            juce::Array<juce::MidiDeviceInfo> probeInputs;
+
+            for (const auto& info : inputs)
+            {
+                if (inUse.contains (info.identifier))
+                    continue;
+
+                auto input = juce::MidiInput::openDevice (info.identifier, this);
+
+                if (input == nullptr)
+                    continue;
+
+                input->start();
+                probeInputs.add (info);
+
+                const juce::ScopedLock sl (replyLock);
+                openInputs.push_back (std::move (input));
+            }
+
+            auto identityRequest = JP8080SysEx::createIdentityRequest();
+            auto identityMessage = juce::MidiMessage::createSysExMessage (identityRequest.data(), static_cast<int> (identityRequest.size()));
+
+            // One output at a time, so every reply tells which output reached the synth
+            for (const auto& info : outputsToProbe)
+            {
+                if (threadShouldExit())
+                    break;
+
+                probedOutputs.addIfNotAlreadyThere (info.identifier);
+
+                auto output = juce::MidiOutput::openDevice (info.identifier);
+                if (output == nullptr)
+                    continue;
+
+                {
+                    const juce::ScopedLock sl (replyLock);
+                    identityReplies.clear();
+                }
+
+                output->sendMessageNow (identityMessage);
+                sleep (replyTimeoutMs);
+
+                const juce::ScopedLock sl (replyLock);
+
+                for (const auto& [inputIndex, deviceId] : identityReplies)
+                    found.push_back ({ info, probeInputs[inputIndex], deviceId });
+            }
+
+            // Close the inputs outside the lock, their callbacks may be waiting on it
+            std::vector<std::unique_ptr<juce::MidiInput>> inputsToClose;
+            {
+                const juce::ScopedLock sl (replyLock);
+                inputsToClose.swap (openInputs);
+            }
+            inputsToClose.clear();
+        }
+
+        // Forget outputs that went away, so they are probed again if they come back
+        for (int i = probedOutputs.size(); --i >= 0;)
+        {
+            const bool present = std::any_of (outputs.begin(), outputs.end(),
+                                              [&] (const juce::MidiDeviceInfo& info) { return info.identifier == probedOutputs[i]; });
+            if (! present)
+                probedOutputs.remove (i);
+        }
+
+        const juce::ScopedLock sl (resultLock);
+
+        if (! std::equal (found.begin(), found.end(), synths.begin(), synths.end(),
+                          [] (const Synth& a, const Synth& b)
+                          {
+                              return a.output == b.output && a.input == b.input && a.deviceId == b.deviceId;
+                          }))
+        {
+            synths = std::move (found);
+            ++generation;
+            sendChangeMessage();
+        }
+    }
+
+    // Called on the MIDI input threads while a probe is running
+    void handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message) override
+    {
+        if (! message.isSysEx())
+            return;
+
+        const juce::ScopedLock sl (replyLock);
+
+        auto it = std::find_if (openInputs.begin(), openInputs.end(),
+                                [source] (const std::unique_ptr<juce::MidiInput>& input) { return input.get() == source; });
+
+        if (it == openInputs.end())
+            return;
+
+        const int inputIndex = static_cast<int> (std::distance (openInputs.begin(), it));
+        uint8_t deviceId = 0;
+
+        if (JP8080SysEx::parseIdentityReply (message.getSysExData(), message.getSysExDataSize(), deviceId))
+            identityReplies.emplace_back (inputIndex, deviceId);
+    }
+
+    juce::CriticalSection resultLock;
+    juce::Array<juce::MidiDeviceInfo> cachedOutputs, cachedInputs;
+    std::vector<Synth> synths;
+    std::atomic<int> generation { 0 };
+    std::atomic<bool> rescanRequested { false };
+    std::map<const void*, juce::StringArray> portsInUse;    // Owner -> output and input identifiers
+
+    juce::StringArray probedOutputs;                        // Discovery thread only
+
+    // Probe state, shared with the input callbacks
+    juce::CriticalSection replyLock;
+    std::vector<std::unique_ptr<juce::MidiInput>> openInputs;
+    std::vector<std::pair<int, uint8_t>> identityReplies;   // (input index, device ID)
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080DeviceDiscovery)
+};
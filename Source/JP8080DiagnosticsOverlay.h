@@ -0,0 +1,66 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Metrics.h"
+
+//==============================================================================
+/**
+ * Diagnostics overlay for the editor
+ *
+ * Shows the processor's message counters and timing histograms on top of the
+ * panels. Does not take mouse clicks, so the controls underneath stay usable.
+ */
+class JP8080DiagnosticsOverlay : public juce::Component
+{
+public:
+    explicit JP8080DiagnosticsOverlay (const JP8080Metrics& metricsToShow)
+        : metrics (metricsToShow)
+    {
+        setInterceptsMouseClicks (false, false);
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        g.setColour (juce::Colour (0xe0101010));
+        g.fillRoundedRectangle (getLocalBounds().toFloat(), 6.0f);
+        g.setColour (juce::Colour (0xffff6600));
+        g.drawRoundedRectangle (getLocalBounds().toFloat().reduced (0.5f), 6.0f, 1.0f);
+
+        auto area = getLocalBounds().reduced (10, 8);
+
+        g.setFont (juce::Font (13.0f, juce::Font::bold));
+        g.drawText ("DIAGNOSTICS", area.removeFromTop (18), juce::Justification::centredLeft, true);
+
+        g.setColour (juce::Colours::lightgrey);
+        g.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+
+        auto drawLine = [&] (const juce::String& text)
+        {
+            g.drawText (text, area.removeFromTop (16), juce::Justification::centredLeft, true);
+        };
+
+        auto formatHistogram = [] (const JP8080Metrics::Histogram& histogram)
+        {
+            return "mean " + juce::String (histogram.getMeanMicros(), 1)
+                 + "  p99 " + juce::String (histogram.getPercentileMicros (0.99))
+                 + "  max " + juce::String (histogram.getMaxMicros()) + " us";
+        };
+
+        drawLine ("Sent     CC " + juce::String (metrics.getMessagesSent (JP8080Metrics::controlChange))
+                  + "  PC " + juce::String (metrics.getMessagesSent (JP8080Metrics::programChange))
+                  + "  SysEx " + juce::String (metrics.getMessagesSent (JP8080Metrics::sysEx))
+                  + "  Clock " + juce::String (metrics.getMessagesSent (JP8080Metrics::clock))
+                  + "  Thru " + juce::String (metrics.getMessagesSent (JP8080Metrics::passThrough)));
+        drawLine ("Coalesced " + juce::String (metrics.getMessagesCoalesced())
+                  + "  Dropped " + juce::String (metrics.getMessagesDropped()));
+        drawLine ("Queue    " + juce::String (metrics.getOutputQueueDepth())
+                  + "  (max " + juce::String (metrics.getMaxOutputQueueDepth()) + ")");
+        drawLine ("Block    " + formatHistogram (metrics.processBlockTime));
+        drawLine ("SysEx    " + formatHistogram (metrics.sysExSendLatency));
+    }
+
+private:
+    const JP8080Metrics& metrics;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080DiagnosticsOverlay)
+};
@@ -0,0 +1,610 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+#include "JP8080SysEx.h"
+#include "JP8080Metrics.h"
+
+//==============================================================================
+/**
+ * Software stand-in for a JP-8080, for testing without the hardware
+ *
+ * Takes the raw MIDI bytes the controller sends, with the time they were
+ * sent, and plays them through a model of the synth's MIDI input:
+ *  - the bytes cross a 31.25 kbaud wire one after another, 320 us each;
+ *  - they wait in an input buffer of limited size while the synth is busy
+ *    with a message. Bytes that arrive at a full buffer are lost, as on the
+ *    real unit (MIDI buffer full);
+ *  - CCs on the Upper and Lower channels (1 and 2), DT1 messages and user
+ *    bank program changes update a memory image: System, the temporary
+ *    performance with both 248-byte temporary patches, and the user patches
+ *    and performances;
+ *  - RQ1 and Identity Requests are answered, and Active Sensing is sent,
+ *    over a 31.25 kbaud return wire.
+ *
+ * The processing times are estimates matching the pacing the controller
+ * itself uses (20 ms per DT1), not measurements. Preset banks are not
+ * modelled: a preset program change leaves the temporary patch as it is.
+ *
+ * Time is supplied by the caller: sample positions for a deterministic
+ * offline run, or the wall clock when serving virtual MIDI ports. Events
+ * are handled in time order when advanceTo() reaches them.
+ */
+class JP8080Emulator
+{
+public:
+    struct Settings
+    {
+        uint8_t deviceId = JP8080SysEx::defaultDeviceId;
+        int inputBufferSize = 256;                  // Bytes
+        double channelMessageMs = 0.0;              // Per CC, note or other channel message
+        double dataSetMs = 20.0;                    // Per DT1, see JP8080BulkTransfer
+        double programChangeMs = 20.0;              // Loading a patch into the temporary performance
+        double activeSensingIntervalMs = 200.0;     // 0 = off
+    };
+
+    // A complete message from the synth (F0/F7 included) at the time its last byte has crossed the wire
+    using OutputCallback = std::function<void (const uint8_t* data, int size, double timeSeconds)>;
+
+    static constexpr double byteSeconds = 10.0 / 31250.0;   // 8N1 at 31.25 kbaud
+    static constexpr int systemSize = 0x20;                 // As much as the controller reads
+    static constexpr int maxSysExSize = 512;
+
+    JP8080Emulator() : JP8080Emulator (Settings()) {}
+
+    explicit JP8080Emulator (const Settings& settingsToUse)
+        : settings (settingsToUse)
+    {
+        using namespace JP8080SysEx;
+
+        addRegion (0, systemSize);
+
+        for (const auto& block : performanceBlocks)
+            addRegion (addressToInt ({ 0x01, 0x00, 0x00, 0x00 }) + block.offset, block.size);
+
+        for (int patchIndex = 0; patchIndex < numUserPatches; ++patchIndex)
+            addRegion (addressToInt (getUserPatchAddress (patchIndex)), patchSize);
+
+        for (int performanceIndex = 0; performanceIndex < numUserPerformances; ++performanceIndex)
+            for (const auto& block : performanceBlocks)
+                addRegion (addressToInt (getUserPerformanceAddress (performanceIndex)) + block.offset, block.size);
+
+        // Patch names are the first 16 bytes of a patch
+        for (auto& [start, bytes] : regions)
+            if (bytes.size() == static_cast<size_t> (patchSize))
+                std::copy_n ("Init Patch      ", 16, bytes.begin());
+
+        for (const auto& [paramID, ccNumber] : JP8080Parameters::ccNumbers)
+            setReceiveCC (paramID, ccNumber);
+    }
+
+    void setOutputCallback (OutputCallback callback)
+    {
+        const juce::ScopedLock sl (lock);
+        output = std::move (callback);
+    }
+
+    // Follows a remapped transmit CC on the controller, -1 to ignore the parameter
+    void setReceiveCC (const juce::String& paramID, int ccNumber)
+    {
+        const auto offset = JP8080Parameters::patchOffsets.find (paramID);
+        if (offset == JP8080Parameters::patchOffsets.end())
+            return;
+
+        const juce::ScopedLock sl (lock);
+
+        for (auto& target : ccTargets)
+            if (target.offset == offset->second.offset)
+                target = {};
+
+        if (juce::isPositiveAndBelow (ccNumber, 128))
+            ccTargets[static_cast<size_t> (ccNumber)] = { offset->second.offset, offset->second.maxValue };
+    }
+
+    //==============================================================================
+    // Bytes as sent by the controller, in sending order
+    void receive (const uint8_t* data, int size, double timeSeconds)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (! connected)
+            return;
+
+        for (int i = 0; i < size; ++i)
+        {
+            lastArrivalTime = juce::jmax (timeSeconds, lastArrivalTime) + byteSeconds;
+            wire.push_back ({ data[i], timeSeconds, lastArrivalTime });
+        }
+    }
+
+    void receive (const juce::MidiMessage& message, double timeSeconds)
+    {
+        receive (message.getRawData(), message.getRawDataSize(), timeSeconds);
+    }
+
+    // Handles everything due up to the given time and delivers the output
+    void advanceTo (double timeSeconds)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (nextActiveSensingTime < 0.0)
+            nextActiveSensingTime = timeSeconds;
+
+        for (;;)
+        {
+            const double nextArrival = wire.empty() ? timeSeconds + 1.0 : wire.front().arrivalTime;
+            const bool sensing = connected && settings.activeSensingIntervalMs > 0.0;
+            const double nextSense = sensing ? nextActiveSensingTime : timeSeconds + 1.0;
+
+            if (juce::jmin (nextArrival, nextSense) > timeSeconds)
+                break;
+
+            if (nextSense < nextArrival)
+            {
+                processInput (nextSense);
+                const uint8_t activeSense = 0xFE;
+                send (&activeSense, 1, nextSense);
+                nextActiveSensingTime += settings.activeSensingIntervalMs * 0.001;
+                continue;
+            }
+
+            const auto byte = wire.front();
+            wire.pop_front();
+            processInput (byte.arrivalTime);
+
+            if (static_cast<int> (inputBuffer.size()) >= settings.inputBufferSize)
+            {
+                ++numBytesDropped;
+                continue;
+            }
+
+            inputBuffer.push_back (byte);
+            maxInputBufferFill = juce::jmax (maxInputBufferFill, static_cast<int> (inputBuffer.size()));
+        }
+
+        processInput (timeSeconds);
+        deliverOutput (timeSeconds);
+    }
+
+    // Handles all input already sent, however long the synth needs for it
+    void flush()
+    {
+        const juce::ScopedLock sl (lock);
+
+        advanceTo (lastArrivalTime);
+        processInput (std::numeric_limits<double>::max());
+        deliverOutput (std::numeric_limits<double>::max());
+    }
+
+    // A pulled MIDI cable: bytes on the way are lost and nothing is sent.
+    // The memory is kept.
+    void setConnected (bool shouldBeConnected)
+    {
+        const juce::ScopedLock sl (lock);
+
+        connected = shouldBeConnected;
+        wire.clear();
+        inputBuffer.clear();
+        pendingOutput.clear();
+        resetParser();
+        nextActiveSensingTime = -1.0;
+    }
+
+    bool isConnected() const
+    {
+        const juce::ScopedLock sl (lock);
+        return connected;
+    }
+
+    //==============================================================================
+    // Memory image, e.g. a temporary patch: readMemory (getTemporaryPatchAddress (0), patchSize).
+    // Stops at the first address the synth doesn't have.
+    std::vector<uint8_t> readMemory (const JP8080SysEx::Address& address, int size) const
+    {
+        const juce::ScopedLock sl (lock);
+
+        std::vector<uint8_t> bytes;
+        const int start = JP8080SysEx::addressToInt (address);
+
+        for (int i = 0; i < size; ++i)
+        {
+            auto* byte = findByte (start + i);
+            if (byte == nullptr)
+                break;
+
+            bytes.push_back (*byte);
+        }
+
+        return bytes;
+    }
+
+    int getNumBytesDropped() const              { const juce::ScopedLock sl (lock); return numBytesDropped; }
+    int getNumRejectedMessages() const          { const juce::ScopedLock sl (lock); return numRejectedMessages; }
+    int getMaxInputBufferFill() const           { const juce::ScopedLock sl (lock); return maxInputBufferFill; }
+
+    // From sending a message's first byte to the end of its processing
+    const JP8080Metrics::Histogram& getLatency() const      { return latency; }
+
+    juce::var toVar() const
+    {
+        const juce::ScopedLock sl (lock);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("messagesHandled", numMessagesHandled);
+        result->setProperty ("bytesDropped", numBytesDropped);
+        result->setProperty ("rejectedMessages", numRejectedMessages);
+        result->setProperty ("repliesSent", numRepliesSent);
+        result->setProperty ("maxInputBufferFill", maxInputBufferFill);
+        result->setProperty ("inputBufferSize", settings.inputBufferSize);
+        result->setProperty ("latency", latency.toVar());
+        return juce::var (result);
+    }
+
+private:
+    struct WireByte
+    {
+        uint8_t byte;
+        double sentTime;
+        double arrivalTime;
+    };
+
+    struct PendingOutput
+    {
+        std::vector<uint8_t> bytes;
+        double time;
+    };
+
+    struct CCTarget
+    {
+        int offset = -1;
+        int maxValue = 0;
+    };
+
+    void addRegion (int start, int size)
+    {
+        regions[start].resize (static_cast<size_t> (size));
+    }
+
+    uint8_t* findByte (int address)
+    {
+        auto it = regions.upper_bound (address);
+        if (it == regions.begin())
+            return nullptr;
+
+        --it;
+        const int offset = address - it->first;
+        return offset < static_cast<int> (it->second.size()) ? &it->second[static_cast<size_t> (offset)] : nullptr;
+    }
+
+    const uint8_t* findByte (int address) const
+    {
+        return const_cast<JP8080Emulator*> (this)->findByte (address);
+    }
+
+    //==============================================================================
+    // Takes bytes from the input buffer for as long as the synth is free before the given time
+    void processInput (double timeSeconds)
+    {
+        while (! inputBuffer.empty() && busyUntil <= timeSeconds)
+        {
+            const auto byte = inputBuffer.front();
+            inputBuffer.pop_front();
+
+            const double now = juce::jmax (busyUntil, byte.arrivalTime);
+            busyUntil = now;
+            parseByte (byte, now);
+        }
+    }
+
+    void parseByte (const WireByte& wireByte, double now)
+    {
+        const uint8_t byte = wireByte.byte;
+
+        // Real-time messages may appear anywhere, even inside SysEx
+        if (byte >= 0xF8)
+            return;
+
+        if (byte == 0xF0)
+        {
+            resetParser();
+            inSysEx = true;
+            messageSentTime = wireByte.sentTime;
+            return;
+        }
+
+        if (byte == 0xF7)
+        {
+            if (inSysEx)
+                handleSysEx (now);
+
+            resetParser();
+            return;
+        }
+
+        if (byte >= 0x80)
+        {
+            // A status byte ends any unterminated SysEx; system common cancels running status
+            if (inSysEx)
+                ++numRejectedMessages;
+
+            resetParser();
+            runningStatus = byte < 0xF0 ? byte : 0;
+            messageSentTime = wireByte.sentTime;
+            return;
+        }
+
+        if (inSysEx)
+        {
+            if (sysex.size() < maxSysExSize)
+                sysex.push_back (byte);
+            else
+                sysexTooLong = true;
+
+            return;
+        }
+
+        if (runningStatus == 0)
+            return;
+
+        // Under running status the message starts with its first data byte
+        if (channelData.empty())
+            messageSentTime = juce::jmin (messageSentTime, wireByte.sentTime);
+
+        channelData.push_back (byte);
+        const int status = runningStatus & 0xF0;
+        const size_t length = (status == 0xC0 || status == 0xD0) ? 1 : 2;
+
+        if (channelData.size() == length)
+        {
+            handleChannelMessage (now);
+            channelData.clear();
+            messageSentTime = std::numeric_limits<double>::max();
+        }
+    }
+
+    void resetParser()
+    {
+        inSysEx = false;
+        sysexTooLong = false;
+        sysex.clear();
+        channelData.clear();
+        runningStatus = 0;
+        messageSentTime = std::numeric_limits<double>::max();
+    }
+
+    void finishMessage (double now, double processingMs)
+    {
+        busyUntil = now + processingMs * 0.001;
+        ++numMessagesHandled;
+
+        if (messageSentTime < std::numeric_limits<double>::max())
+            latency.record (static_cast<juce::int64> ((busyUntil - messageSentTime) * 1.0e6));
+    }
+
+    //==============================================================================
+    void handleChannelMessage (double now)
+    {
+        const int status = runningStatus & 0xF0;
+        const int channel = (runningStatus & 0x0F) + 1;
+        const int partIndex = channel - 1;      // Upper receives on 1, Lower on 2
+
+        if (status == 0xB0 && (channel == 1 || channel == 2))
+        {
+            const int ccNumber = channelData[0];
+            const int value = channelData[1];
+
+            if (ccNumber == 0)
+                bankMSB[static_cast<size_t> (partIndex)] = value;
+            else if (ccNumber == 32)
+                bankLSB[static_cast<size_t> (partIndex)] = value;
+            else if (const auto& target = ccTargets[static_cast<size_t> (ccNumber)]; target.offset >= 0)
+                writeTemporaryPatch (partIndex, target.offset, juce::roundToInt (value * target.maxValue / 127.0f));
+        }
+        else if (status == 0xC0 && (channel == 1 || channel == 2))
+        {
+            // User bank: A11-B88 as programs 0-127
+            if (bankMSB[static_cast<size_t> (partIndex)] == 80)
+                loadUserPatch (partIndex, channelData[0]);
+
+            finishMessage (now, settings.programChangeMs);
+            return;
+        }
+
+        finishMessage (now, settings.channelMessageMs);
+    }
+
+    void writeTemporaryPatch (int partIndex, int offset, int value)
+    {
+        const int start = JP8080SysEx::addressToInt (JP8080SysEx::getTemporaryPatchAddress (partIndex));
+
+        if (auto* byte = findByte (start + offset))
+            *byte = static_cast<uint8_t> (juce::jlimit (0, 127, value));
+    }
+
+    void loadUserPatch (int partIndex, int patchIndex)
+    {
+        using namespace JP8080SysEx;
+
+        const int source = addressToInt (getUserPatchAddress (patchIndex));
+        const int destination = addressToInt (getTemporaryPatchAddress (partIndex));
+
+        for (int i = 0; i < patchSize; ++i)
+            if (auto* from = findByte (source + i))
+                if (auto* to = findByte (destination + i))
+                    *to = *from;
+    }
+
+    //==============================================================================
+    void handleSysEx (double now)
+    {
+        using namespace JP8080SysEx;
+
+        const auto* data = sysex.data();
+        const int size = static_cast<int> (sysex.size());
+
+        if (sysexTooLong)
+        {
+            ++numRejectedMessages;
+            return;
+        }
+
+        // Identity Request, to this device or broadcast
+        if (size == 4 && data[0] == 0x7E && data[2] == 0x06 && data[3] == 0x01)
+        {
+            if (data[1] == broadcastDeviceId || data[1] == settings.deviceId)
+            {
+                const uint8_t reply[] = { 0xF0, 0x7E, settings.deviceId, 0x06, 0x02, rolandId, 0x06, 0x01,
+                                          0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0xF7 };
+                send (reply, static_cast<int> (sizeof (reply)), now);
+                ++numRepliesSent;
+            }
+
+            finishMessage (now, settings.channelMessageMs);
+            return;
+        }
+
+        if (size < headerSize || data[0] != rolandId || data[2] != modelIdMsb || data[3] != modelIdLsb)
+        {
+            finishMessage (now, settings.channelMessageMs);
+            return;
+        }
+
+        // Another device ID: not for this unit
+        if (data[1] != settings.deviceId)
+            return;
+
+        if (data[4] == commandDT1)
+        {
+            DataSet dataSet;
+            if (! parseDataSet (data, size, dataSet))
+            {
+                ++numRejectedMessages;
+                return;
+            }
+
+            const int start = addressToInt (dataSet.address);
+            for (int i = 0; i < dataSet.size; ++i)
+                if (auto* byte = findByte (start + i))
+                    *byte = dataSet.data[i];
+
+            finishMessage (now, settings.dataSetMs);
+            return;
+        }
+
+        if (data[4] == commandRQ1)
+        {
+            if (size != headerSize + addressSize * 2 + 1
+                 || calculateChecksum (data + headerSize, addressSize * 2) != data[size - 1])
+            {
+                ++numRejectedMessages;
+                return;
+            }
+
+            Address address, sizeBytes;
+            std::copy_n (data + headerSize, addressSize, address.begin());
+            std::copy_n (data + headerSize + addressSize, addressSize, sizeBytes.begin());
+
+            sendDataSets (addressToInt (address), addressToInt (sizeBytes), now);
+            finishMessage (now, settings.channelMessageMs);
+            return;
+        }
+
+        ++numRejectedMessages;
+    }
+
+    // The requested range as DT1 messages, split where the last address byte wraps
+    void sendDataSets (int start, int size, double now)
+    {
+        std::vector<uint8_t> chunk;
+        int chunkStart = start;
+
+        auto flushChunk = [&]
+        {
+            if (chunk.empty())
+                return;
+
+            auto message = JP8080SysEx::createDataSet (settings.deviceId, JP8080SysEx::intToAddress (chunkStart),
+                                                       chunk.data(), chunk.size());
+            message.insert (message.begin(), 0xF0);
+            message.push_back (0xF7);
+            send (message.data(), static_cast<int> (message.size()), now);
+            ++numRepliesSent;
+            chunk.clear();
+        };
+
+        for (int address = start; address < start + size; ++address)
+        {
+            auto* byte = findByte (address);
+            if (byte == nullptr)
+                break;
+
+            if (! chunk.empty() && (address & 0x7F) == 0)
+            {
+                flushChunk();
+                chunkStart = address;
+            }
+
+            chunk.push_back (*byte);
+        }
+
+        flushChunk();
+    }
+
+    //==============================================================================
+    // Queues a message on the return wire
+    void send (const uint8_t* data, int size, double now)
+    {
+        outputFreeTime = juce::jmax (now, outputFreeTime) + size * byteSeconds;
+        pendingOutput.push_back ({ std::vector<uint8_t> (data, data + size), outputFreeTime });
+    }
+
+    void deliverOutput (double timeSeconds)
+    {
+        while (! pendingOutput.empty() && pendingOutput.front().time <= timeSeconds)
+        {
+            const auto message = std::move (pendingOutput.front());
+            pendingOutput.pop_front();
+
+            if (output != nullptr)
+                output (message.bytes.data(), static_cast<int> (message.bytes.size()), message.time);
+        }
+    }
+
+    //==============================================================================
+    juce::CriticalSection lock;
+    Settings settings;
+    OutputCallback output;
+    bool connected = true;
+
+    // Start address -> bytes, in 7-bit address arithmetic
+    std::map<int, std::vector<uint8_t>> regions;
+    std::array<CCTarget, 128> ccTargets;
+    std::array<int, 2> bankMSB { 80, 80 };
+    std::array<int, 2> bankLSB { 0, 0 };
+
+    std::deque<WireByte> wire;
+    std::deque<WireByte> inputBuffer;
+    double lastArrivalTime = 0.0;
+    double busyUntil = 0.0;
+    double nextActiveSensingTime = -1.0;
+
+    // Parser
+    bool inSysEx = false;
+    bool sysexTooLong = false;
+    std::vector<uint8_t> sysex;
+    std::vector<uint8_t> channelData;
+    uint8_t runningStatus = 0;
+    double messageSentTime = std::numeric_limits<double>::max();
+
+    std::deque<PendingOutput> pendingOutput;
+    double outputFreeTime = 0.0;
+
+    int numMessagesHandled = 0;
+    int numBytesDropped = 0;
+    int numRejectedMessages = 0;
+    int numRepliesSent = 0;
+    int maxInputBufferFill = 0;
+    JP8080Metrics::Histogram latency;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080Emulator)
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * Lightweight slider-to-parameter attachment for the editor knobs
+ *
+ * Unlike SliderAttachment it does not listen to the parameter: the slider
+ * only follows parameter changes when the editor calls updateFromParameter()
+ * from its refresh timer, so dense automation costs one repaint per frame
+ * rather than one per change.
+ */
+class JP8080KnobAttachment
+{
+public:
+    JP8080KnobAttachment (juce::RangedAudioParameter& parameterToUse, juce::Slider& sliderToUse)
+        : parameter (parameterToUse), slider (sliderToUse)
+    {
+        slider.onValueChange = [this]
+        {
+            if (! updatingSlider)
+                parameter.setValueNotifyingHost (parameter.convertTo0to1 (static_cast<float> (slider.getValue())));
+        };
+
+        slider.onDragStart = [this] { parameter.beginChangeGesture(); };
+        slider.onDragEnd = [this] { parameter.endChangeGesture(); };
+
+        updateFromParameter();
+    }
+
+    ~JP8080KnobAttachment()
+    {
+        slider.onValueChange = nullptr;
+        slider.onDragStart = nullptr;
+        slider.onDragEnd = nullptr;
+    }
+
+    // Message thread: move the slider to the current parameter value
+    void updateFromParameter()
+    {
+        const juce::ScopedValueSetter<bool> svs (updatingSlider, true);
+        slider.setValue (parameter.convertFrom0to1 (parameter.getValue()), juce::dontSendNotification);
+    }
+
+    juce::Slider& getSlider() const             { return slider; }
+
+private:
+    juce::RangedAudioParameter& parameter;
+    juce::Slider& slider;
+    bool updatingSlider = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080KnobAttachment)
+};
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+#include "JP8080BurstCompiler.h"
+
+//==============================================================================
+/**
+ * Parameter-lock step sequencer
+ *
+ * Up to 64 steps of a sixteenth note each, following the host transport.
+ * Every step can lock any of the CC parameters and the SysEx selectors
+ * (waveforms and effect types) to its own value. A locked value holds for
+ * its step only; on the next step without that lock the parameter returns
+ * to its knob value.
+ *
+ * Editing happens on the message thread and marks the pattern for
+ * compilation. The compiled pattern has, for each step and each part, the
+ * lock CCs as running-status bytes and the finished DT1 messages, and is
+ * handed to the audio thread through a single pointer exchange. The audio thread then only
+ * works out where the step boundaries fall in the block and copies the
+ * step's events; the processor sends them and restores released locks.
+ */
+class JP8080LockSequencer : private juce::AsyncUpdater
+{
+public:
+    static constexpr int maxSteps = 64;
+    static constexpr int maxTriggersPerBlock = 32;
+    static constexpr double stepLengthPpq = 0.25;       // Sixteenth notes
+
+    // Builds the DT1 message that sets a SysEx parameter for a part
+    using SysExBuilder = std::function<std::vector<uint8_t> (const juce::String& paramID, int value, int partIndex)>;
+
+    // The CC a parameter is sent on, -1 for none
+    using CCNumberLookup = std::function<int (const juce::String& paramID)>;
+
+    // CC parameters first, in getAllParameterIDs() order, then the SysEx selectors
+    static const std::vector<juce::String>& getLockableParameterIDs()
+    {
+        static const std::vector<juce::String> ids = []
+        {
+            using namespace JP8080Parameters;
+
+            auto all = getAllParameterIDs();
+            for (const auto& id : { Oscillator::osc1Waveform, Oscillator::osc2Waveform, LFO::lfo1Waveform,
+                                    Effects::multiFxType, Effects::delayType })
+                all.push_back (id);
+
+            return all;
+        }();
+
+        return ids;
+    }
+
+    static int getLockIndex (const juce::String& paramID)
+    {
+        static const std::map<juce::String, int> indices = []
+        {
+            std::map<juce::String, int> map;
+            const auto& ids = getLockableParameterIDs();
+
+            for (size_t i = 0; i < ids.size(); ++i)
+                map[ids[i]] = static_cast<int> (i);
+
+            return map;
+        }();
+
+        auto it = indices.find (paramID);
+        return it != indices.end() ? it->second : -1;
+    }
+
+    using LockMask = std::bitset<64>;
+
+    struct SysEx
+    {
+        int lockIndex;
+        std::vector<uint8_t> data;
+    };
+
+    struct CompiledStep
+    {
+        LockMask locks;
+        std::vector<uint8_t> controlChanges;       // Running status, see JP8080BurstCompiler
+        std::vector<SysEx> sysExMessages;
+    };
+
+    struct Trigger
+    {
+        const CompiledStep* step;
+        int sampleOffset;
+    };
+
+    using TriggerList = std::array<Trigger, maxTriggersPerBlock>;
+
+    //==============================================================================
+    JP8080LockSequencer (SysExBuilder builder, CCNumberLookup ccLookup)
+        : buildSysEx (std::move (builder)), getCCNumber (std::move (ccLookup))
+    {
+        jassert (getLockableParameterIDs().size() <= LockMask().size());
+        compile();
+    }
+
+    ~JP8080LockSequencer() override
+    {
+        cancelPendingUpdate();
+        delete pendingPattern.exchange (nullptr);
+        delete retiredPattern.exchange (nullptr);
+        delete activePattern;
+    }
+
+    //==============================================================================
+    // Message thread: editing
+    void setEnabled (bool shouldBeEnabled)      { enabled = shouldBeEnabled; triggerAsyncUpdate(); }
+    bool isEnabled() const                      { return enabled; }
+
+    void setLength (int numSteps)               { length = juce::jlimit (1, maxSteps, numSteps); triggerAsyncUpdate(); }
+    int getLength() const                       { return length; }
+
+    void setLock (int step, const juce::String& paramID, float plainValue)
+    {
+        if (! juce::isPositiveAndBelow (step, maxSteps) || getLockIndex (paramID) < 0)
+            return;
+
+        steps[static_cast<size_t> (step)][paramID] = plainValue;
+        triggerAsyncUpdate();
+    }
+
+    void removeLock (int step, const juce::String& paramID)
+    {
+        if (juce::isPositiveAndBelow (step, maxSteps) && steps[static_cast<size_t> (step)].erase (paramID) > 0)
+            triggerAsyncUpdate();
+    }
+
+    void clearStep (int step)
+    {
+        if (juce::isPositiveAndBelow (step, maxSteps))
+        {
+            steps[static_cast<size_t> (step)].clear();
+            triggerAsyncUpdate();
+        }
+    }
+
+    void clear()
+    {
+        for (auto& step : steps)
+            step.clear();
+
+        triggerAsyncUpdate();
+    }
+
+    // One edit from outside the editor (OSC, a replay timeline)
+    struct Edit
+    {
+        enum Type
+        {
+            lock,           // Lock paramID to value on step
+            unlock,         // Remove paramID's lock from step, or all of its locks if paramID is empty
+            settings        // Switch on if value > 0.5, and set the length to step unless it's -1
+        };
+
+        Type type = lock;
+        int step = -1;
+        juce::String paramID;
+        float value = 0.0f;
+    };
+
+    void apply (const Edit& edit)
+    {
+        switch (edit.type)
+        {
+            case Edit::lock:
+                setLock (edit.step, edit.paramID, edit.value);
+                break;
+
+            case Edit::unlock:
+                if (edit.paramID.isEmpty())
+                    clearStep (edit.step);
+                else
+                    removeLock (edit.step, edit.paramID);
+                break;
+
+            case Edit::settings:
+                setEnabled (edit.value > 0.5f);
+                if (edit.step >= 0)
+                    setLength (edit.step);
+                break;
+        }
+    }
+
+    // Compiles pending edits now rather than on the next message loop turn
+    // (offline render, where there is no message loop)
+    void flushEdits()                           { handleUpdateNowIfNeeded(); }
+
+    // Locks of a step as parameter ID -> plain value
+    const std::map<juce::String, float>& getLocks (int step) const
+    {
+        return steps[static_cast<size_t> (juce::jlimit (0, maxSteps - 1, step))];
+    }
+
+    // The messages depend on the device ID and the CC map: rebuild them after either changes
+    void recompile()                            { triggerAsyncUpdate(); }
+
+    //==============================================================================
+    // Plugin state
+    juce::ValueTree toValueTree() const
+    {
+        juce::ValueTree tree ("LockSequencer");
+        tree.setProperty ("enabled", enabled, nullptr);
+        tree.setProperty ("length", length, nullptr);
+
+        for (int i = 0; i < maxSteps; ++i)
+        {
+            for (const auto& [paramID, value] : steps[static_cast<size_t> (i)])
+            {
+                juce::ValueTree lock ("Lock");
+                lock.setProperty ("step", i, nullptr);
+                lock.setProperty ("id", paramID, nullptr);
+                lock.setProperty ("value", value, nullptr);
+                tree.appendChild (lock, nullptr);
+            }
+        }
+
+        return tree;
+    }
+
+    void fromValueTree (const juce::ValueTree& tree)
+    {
+        for (auto& step : steps)
+            step.clear();
+
+        enabled = tree.getProperty ("enabled", false);
+        length = juce::jlimit (1, maxSteps, static_cast<int> (tree.getProperty ("length", 16)));
+
+        for (const auto& lock : tree)
+            if (lock.hasType ("Lock"))
+                setLock (lock.getProperty ("step"), lock.getProperty ("id").toString(), lock.getProperty ("value"));
+
+        triggerAsyncUpdate();
+    }
+
+    //==============================================================================
+    // Audio thread. Finds the step boundaries inside this block and returns
+    // the steps starting there for the given part. Steps are counted from
+    // PPQ 0, so the pattern stays aligned to the host's bars.
+    int process (const juce::Optional<juce::AudioPlayHead::PositionInfo>& position, int partIndex,
+                 int numSamples, double sampleRate, TriggerList& triggers)
+    {
+        takePendingPattern();
+
+        juce::Optional<double> ppq;
+        juce::Optional<double> bpm;
+
+        if (position.hasValue() && position->getIsPlaying())
+        {
+            ppq = position->getPpqPosition();
+            bpm = position->getBpm();
+        }
+
+        if (activePattern == nullptr || ! activePattern->enabled || ! ppq.hasValue() || ! bpm.hasValue()
+             || *bpm <= 0.0 || sampleRate <= 0.0)
+        {
+            playing = false;
+            return 0;
+        }
+
+        const auto& pattern = *activePattern;
+        const auto& partSteps = pattern.steps[static_cast<size_t> (partIndex == 0 ? 0 : 1)];
+        const double ppqPerSample = *bpm / 60.0 / sampleRate;
+        const double blockStart = *ppq;
+        int numTriggers = 0;
+
+        auto addTrigger = [&] (juce::int64 stepNumber, int sampleOffset)
+        {
+            if (numTriggers < maxTriggersPerBlock)
+                triggers[static_cast<size_t> (numTriggers++)] = { &partSteps[static_cast<size_t> (stepNumber % pattern.length)],
+                                                                  sampleOffset };
+        };
+
+        // Started or jumped: the step under the playhead applies from the first sample
+        auto firstBoundary = static_cast<juce::int64> (std::ceil (blockStart / stepLengthPpq - 1.0e-9));
+
+        if (! playing || std::abs (blockStart - expectedPpq) > stepLengthPpq * 0.5)
+        {
+            const auto current = static_cast<juce::int64> (std::floor (blockStart / stepLengthPpq + 1.0e-9));
+            if (current >= 0 && current < firstBoundary)
+                addTrigger (current, 0);
+        }
+
+        for (auto boundary = juce::jmax (juce::int64 (0), firstBoundary);; ++boundary)
+        {
+            const double offset = (static_cast<double> (boundary) * stepLengthPpq - blockStart) / ppqPerSample;
+            if (offset >= numSamples)
+                break;
+
+            addTrigger (boundary, juce::jmax (0, static_cast<int> (offset)));
+        }
+
+        playing = true;
+        expectedPpq = blockStart + numSamples * ppqPerSample;
+        return numTriggers;
+    }
+
+    // Audio thread: false once the transport stops or the sequencer is switched off
+    bool isPlaying() const                      { return playing; }
+
+private:
+    struct CompiledPattern
+    {
+        bool enabled = false;
+        int length = 16;
+        std::array<std::vector<CompiledStep>, 2> steps;     // Upper, Lower
+    };
+
+    //==============================================================================
+    void handleAsyncUpdate() override
+    {
+        compile();
+    }
+
+    // Message thread: builds every step's events and hands them to the audio thread
+    void compile()
+    {
+        auto pattern = std::make_unique<CompiledPattern>();
+        pattern->enabled = enabled;
+        pattern->length = length;
+
+        for (int partIndex = 0; partIndex < 2; ++partIndex)
+        {
+            auto& partSteps = pattern->steps[static_cast<size_t> (partIndex)];
+            partSteps.resize (maxSteps);
+
+            for (int i = 0; i < maxSteps; ++i)
+            {
+                auto& compiled = partSteps[static_cast<size_t> (i)];
+                std::vector<JP8080BurstCompiler::Change> controlChanges;
+
+                for (const auto& [paramID, plainValue] : steps[static_cast<size_t> (i)])
+                {
+                    const int lockIndex = getLockIndex (paramID);
+                    const int value = juce::roundToInt (plainValue);
+                    const int ccNumber = getCCNumber != nullptr ? getCCNumber (paramID)
+                                                                : JP8080Parameters::getCCNumber (paramID);
+
+                    compiled.locks.set (static_cast<size_t> (lockIndex));
+
+                    if (ccNumber >= 0)
+                        controlChanges.push_back ({ ccNumber, value, -1, -1 });
+                    else if (buildSysEx != nullptr)
+                        if (auto data = buildSysEx (paramID, value, partIndex); ! data.empty())
+                            compiled.sysExMessages.push_back ({ lockIndex, std::move (data) });
+                }
+
+                JP8080BurstCompiler::encodeControlChanges (controlChanges, compiled.controlChanges);
+            }
+        }
+
+        // The audio thread picks up a new pattern only once the one it replaced has been freed here
+        delete retiredPattern.exchange (nullptr);
+        delete pendingPattern.exchange (pattern.release());
+    }
+
+    // Audio thread
+    void takePendingPattern()
+    {
+        if (retiredPattern.load() != nullptr)
+            return;
+
+        if (auto* next = pendingPattern.exchange (nullptr))
+        {
+            retiredPattern.store (activePattern);
+            activePattern = next;
+        }
+    }
+
+    //==============================================================================
+    SysExBuilder buildSysEx;
+    CCNumberLookup getCCNumber;
+
+    // Message thread
+    std::array<std::map<juce::String, float>, maxSteps> steps;
+    bool enabled = false;
+    int length = 16;
+
+    // Message thread -> audio thread
+    std::atomic<CompiledPattern*> pendingPattern { nullptr };
+    std::atomic<CompiledPattern*> retiredPattern { nullptr };
+
+    // Audio thread
+    CompiledPattern* activePattern = nullptr;
+    bool playing = false;
+    double expectedPpq = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080LockSequencer)
+};
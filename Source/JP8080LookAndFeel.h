@@ -6,7 +6,9 @@
 /**
  * Custom LookAndFeel for JP-8080 Controller
  *
- * Provides custom rendering for rotary knobs with a hardware-inspired design
+ * Provides custom rendering for rotary knobs with a hardware-inspired design.
+ * Knobs are pre-rendered into a 128-frame filmstrip per size and display
+ * scale, so drawing a knob is a single image blit.
  */
 class JP8080LookAndFeel : public juce::LookAndFeel_V4
 {
@@ -29,7 +31,114 @@ public:
                          float sliderPosProportional, float rotaryStartAngle,
                          float rotaryEndAngle, juce::Slider& slider) override
     {
-        auto bounds = juce::Rectangle<int>(x, y, width, height).toFloat().reduced(10);
+        if (! useKnobCache)
+        {
+            drawKnob(g, juce::Rectangle<int>(x, y, width, height).toFloat(), sliderPosProportional,
+                     rotaryStartAngle, rotaryEndAngle, slider.isEnabled());
+            return;
+        }
+
+        // Blit the pre-rendered frame for this value (0-127)
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        auto& strip = getKnobStrip(width, height, scale, rotaryStartAngle, rotaryEndAngle, slider.isEnabled());
+        int frame = juce::jlimit(0, numKnobFrames - 1, juce::roundToInt(sliderPosProportional * (numKnobFrames - 1)));
+
+        renderKnobFrameIfNeeded(strip, frame);
+
+        g.drawImage(strip.image, x, y, width, height,
+                    0, frame * strip.frameHeight, strip.frameWidth, strip.frameHeight);
+    }
+
+    // Vector drawing is used directly when the cache is disabled
+    void setUseKnobCache(bool shouldUseCache)
+    {
+        useKnobCache = shouldUseCache;
+        knobStrips.clear();
+    }
+
+    juce::Label* createSliderTextBox(juce::Slider& slider) override
+    {
+        auto* label = new juce::Label();
+        label->setJustificationType(juce::Justification::centred);
+        label->setColour(juce::Label::textColourId, slider.findColour(juce::Slider::textBoxTextColourId));
+        label->setColour(juce::Label::backgroundColourId, juce::Colour(0x00000000));
+        label->setColour(juce::Label::outlineColourId, juce::Colour(0x00000000));
+        label->setFont(juce::Font(11.0f));
+        return label;
+    }
+
+private:
+    //==============================================================================
+    // Knob filmstrip cache
+    // One strip of 128 frames per knob size and state, rendered at the display
+    // scale. Frames are rendered on first use.
+    static constexpr int numKnobFrames = 128;
+
+    struct KnobStrip
+    {
+        int width = 0, height = 0;
+        float scale = 1.0f, startAngle = 0.0f, endAngle = 0.0f;
+        bool enabled = true;
+
+        int frameWidth = 0, frameHeight = 0;
+        juce::Image image;
+        std::bitset<numKnobFrames> rendered;
+    };
+
+    KnobStrip& getKnobStrip(int width, int height, float scale,
+                            float startAngle, float endAngle, bool enabled)
+    {
+        // A new scale factor (e.g. window moved to another display) invalidates every strip
+        if (scale != cachedScale)
+        {
+            knobStrips.clear();
+            cachedScale = scale;
+        }
+
+        for (auto& strip : knobStrips)
+        {
+            if (strip.width == width && strip.height == height && strip.enabled == enabled
+                && strip.startAngle == startAngle && strip.endAngle == endAngle)
+                return strip;
+        }
+
+        KnobStrip strip;
+        strip.width = width;
+        strip.height = height;
+        strip.scale = scale;
+        strip.startAngle = startAngle;
+        strip.endAngle = endAngle;
+        strip.enabled = enabled;
+        strip.frameWidth = juce::roundToInt(width * scale);
+        strip.frameHeight = juce::roundToInt(height * scale);
+        strip.image = juce::Image(juce::Image::ARGB, juce::jmax(1, strip.frameWidth),
+                                  juce::jmax(1, strip.frameHeight * numKnobFrames), true);
+
+        knobStrips.push_back(std::move(strip));
+        return knobStrips.back();
+    }
+
+    void renderKnobFrameIfNeeded(KnobStrip& strip, int frame)
+    {
+        if (strip.rendered[static_cast<size_t>(frame)])
+            return;
+
+        juce::Graphics g(strip.image);
+        g.reduceClipRegion(0, frame * strip.frameHeight, strip.frameWidth, strip.frameHeight);
+        g.addTransform(juce::AffineTransform::scale(strip.scale)
+                           .translated(0.0f, static_cast<float>(frame * strip.frameHeight)));
+
+        drawKnob(g, juce::Rectangle<float>(0.0f, 0.0f, static_cast<float>(strip.width), static_cast<float>(strip.height)),
+                 static_cast<float>(frame) / (numKnobFrames - 1), strip.startAngle, strip.endAngle, strip.enabled);
+
+        strip.rendered.set(static_cast<size_t>(frame));
+    }
+
+    //==============================================================================
+    void drawKnob(juce::Graphics& g, juce::Rectangle<float> area, float sliderPosProportional,
+                  float rotaryStartAngle, float rotaryEndAngle, bool enabled)
+    {
+        auto bounds = area.reduced(10);
         auto radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f;
         auto toAngle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
         auto lineW = juce::jmin(8.0f, radius * 0.5f);
@@ -56,7 +165,7 @@ public:
         g.strokePath(backgroundArc, juce::PathStrokeType(lineW, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
 
         // Draw value arc
-        if (slider.isEnabled())
+        if (enabled)
         {
             juce::Path valueArc;
             valueArc.addCentredArc(bounds.getCentreX(), bounds.getCentreY(),
@@ -71,18 +180,11 @@ public:
         auto pointerLength = radius * 0.6f;
         auto pointerThickness = 3.0f;
         pointer.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
-        g.setColour(slider.isEnabled() ? findColour(juce::Slider::thumbColourId) : juce::Colour(0xff404040));
+        g.setColour(enabled ? findColour(juce::Slider::thumbColourId) : juce::Colour(0xff404040));
         g.fillPath(pointer, juce::AffineTransform::rotation(toAngle).translated(bounds.getCentreX(), bounds.getCentreY()));
     }
 
-    juce::Label* createSliderTextBox(juce::Slider& slider) override
-    {
-        auto* label = new juce::Label();
-        label->setJustificationType(juce::Justification::centred);
-        label->setColour(juce::Label::textColourId, slider.findColour(juce::Slider::textBoxTextColourId));
-        label->setColour(juce::Label::backgroundColourId, juce::Colour(0x00000000));
-        label->setColour(juce::Label::outlineColourId, juce::Colour(0x00000000));
-        label->setFont(juce::Font(11.0f));
-        return label;
-    }
+    bool useKnobCache = true;
+    float cachedScale = 1.0f;
+    std::vector<KnobStrip> knobStrips;
 };
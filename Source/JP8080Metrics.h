@@ -0,0 +1,230 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * Lock-free performance counters for one processor instance
+ *
+ * Written from the audio thread, the MIDI input thread and the background
+ * threads with relaxed atomics only; read at any time as a snapshot by the
+ * editor's diagnostics overlay or dumped as JSON by the headless harness.
+ */
+class JP8080Metrics
+{
+public:
+    JP8080Metrics() = default;
+
+    enum MessageType
+    {
+        controlChange = 0,
+        programChange,
+        sysEx,
+        clock,                  // MIDI clock and transport
+        passThrough,            // Incoming MIDI passed on to the synth
+        numMessageTypes
+    };
+
+    //==============================================================================
+    // Latency histogram with power-of-two microsecond buckets:
+    // bucket 0 = < 1 us, bucket n = [2^(n-1), 2^n) us, last bucket = everything above
+    static constexpr int numHistogramBuckets = 20;
+
+    class Histogram
+    {
+    public:
+        void record (juce::int64 micros)
+        {
+            micros = juce::jmax (juce::int64 (0), micros);
+
+            int bucket = 0;
+            while (bucket < numHistogramBuckets - 1 && (juce::int64 (1) << bucket) <= micros)
+                ++bucket;
+
+            buckets[static_cast<size_t> (bucket)].fetch_add (1, std::memory_order_relaxed);
+            count.fetch_add (1, std::memory_order_relaxed);
+            totalMicros.fetch_add (micros, std::memory_order_relaxed);
+
+            auto previousMax = maxMicros.load (std::memory_order_relaxed);
+            while (micros > previousMax
+                   && ! maxMicros.compare_exchange_weak (previousMax, micros, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        juce::int64 getCount() const            { return count.load (std::memory_order_relaxed); }
+        juce::int64 getMaxMicros() const        { return maxMicros.load (std::memory_order_relaxed); }
+        uint32_t getBucket (int index) const    { return buckets[static_cast<size_t> (index)].load (std::memory_order_relaxed); }
+
+        double getMeanMicros() const
+        {
+            auto n = getCount();
+            return n > 0 ? static_cast<double> (totalMicros.load (std::memory_order_relaxed)) / static_cast<double> (n) : 0.0;
+        }
+
+        // Upper bound (in us) of the bucket containing the given percentile (0-1)
+        juce::int64 getPercentileMicros (double percentile) const
+        {
+            const auto n = getCount();
+            if (n == 0)
+                return 0;
+
+            const auto target = static_cast<juce::int64> (std::ceil (percentile * static_cast<double> (n)));
+            juce::int64 seen = 0;
+
+            for (int i = 0; i < numHistogramBuckets; ++i)
+            {
+                seen += getBucket (i);
+
+                if (seen >= target)
+                    return i == numHistogramBuckets - 1 ? getMaxMicros() : (juce::int64 (1) << i);
+            }
+
+            return getMaxMicros();
+        }
+
+        void reset()
+        {
+            for (auto& bucket : buckets)
+                bucket.store (0, std::memory_order_relaxed);
+
+            count.store (0, std::memory_order_relaxed);
+            totalMicros.store (0, std::memory_order_relaxed);
+            maxMicros.store (0, std::memory_order_relaxed);
+        }
+
+        juce::var toVar() const
+        {
+            auto* object = new juce::DynamicObject();
+            juce::Array<juce::var> bucketValues;
+
+            for (int i = 0; i < numHistogramBuckets; ++i)
+                bucketValues.add (static_cast<int> (getBucket (i)));
+
+            object->setProperty ("count", getCount());
+            object->setProperty ("meanMicros", getMeanMicros());
+            object->setProperty ("p50Micros", getPercentileMicros (0.5));
+            object->setProperty ("p99Micros", getPercentileMicros (0.99));
+            object->setProperty ("maxMicros", getMaxMicros());
+            object->setProperty ("log2Buckets", bucketValues);
+            return juce::var (object);
+        }
+
+    private:
+        std::array<std::atomic<uint32_t>, numHistogramBuckets> buckets {};
+        std::atomic<juce::int64> count { 0 };
+        std::atomic<juce::int64> totalMicros { 0 };
+        std::atomic<juce::int64> maxMicros { 0 };
+    };
+
+    //==============================================================================
+    // Measures the lifetime of the enclosing scope into a histogram
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer (Histogram& histogramToUse)
+            : histogram (histogramToUse), startTicks (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            histogram.record (ticksToMicros (juce::Time::getHighResolutionTicks() - startTicks));
+        }
+
+    private:
+        Histogram& histogram;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+    static juce::int64 ticksToMicros (juce::int64 ticks)
+    {
+        return static_cast<juce::int64> (juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6);
+    }
+
+    //==============================================================================
+    void countSent (MessageType type, int count = 1)
+    {
+        messagesSent[static_cast<size_t> (type)].fetch_add (count, std::memory_order_relaxed);
+    }
+
+    // Parameter changes superseded by a later change before they were sent
+    void countCoalesced (int numChanges)
+    {
+        if (numChanges > 0)
+            messagesCoalesced.fetch_add (numChanges, std::memory_order_relaxed);
+    }
+
+    // Messages discarded (no output device open)
+    void countDropped()
+    {
+        messagesDropped.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    // Events queued into the host's output buffer by one processBlock
+    void setOutputQueueDepth (int depth)
+    {
+        outputQueueDepth.store (depth, std::memory_order_relaxed);
+
+        auto previousMax = maxOutputQueueDepth.load (std::memory_order_relaxed);
+        while (depth > previousMax
+               && ! maxOutputQueueDepth.compare_exchange_weak (previousMax, depth, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    Histogram processBlockTime;         // processBlock duration
+    Histogram sysExSendLatency;         // sendSysExDirect entry or audio-thread queueing to sendMessageNow return
+
+    //==============================================================================
+    juce::int64 getMessagesSent (MessageType type) const   { return messagesSent[static_cast<size_t> (type)].load (std::memory_order_relaxed); }
+    juce::int64 getMessagesCoalesced() const               { return messagesCoalesced.load (std::memory_order_relaxed); }
+    juce::int64 getMessagesDropped() const                 { return messagesDropped.load (std::memory_order_relaxed); }
+    int getOutputQueueDepth() const                        { return outputQueueDepth.load (std::memory_order_relaxed); }
+    int getMaxOutputQueueDepth() const                     { return maxOutputQueueDepth.load (std::memory_order_relaxed); }
+
+    void reset()
+    {
+        for (auto& counter : messagesSent)
+            counter.store (0, std::memory_order_relaxed);
+
+        messagesCoalesced.store (0, std::memory_order_relaxed);
+        messagesDropped.store (0, std::memory_order_relaxed);
+        outputQueueDepth.store (0, std::memory_order_relaxed);
+        maxOutputQueueDepth.store (0, std::memory_order_relaxed);
+        processBlockTime.reset();
+        sysExSendLatency.reset();
+    }
+
+    juce::String toJSON() const
+    {
+        auto* sent = new juce::DynamicObject();
+        sent->setProperty ("controlChange", getMessagesSent (controlChange));
+        sent->setProperty ("programChange", getMessagesSent (programChange));
+        sent->setProperty ("sysEx", getMessagesSent (sysEx));
+        sent->setProperty ("clock", getMessagesSent (clock));
+        sent->setProperty ("passThrough", getMessagesSent (passThrough));
+
+        auto* object = new juce::DynamicObject();
+        object->setProperty ("messagesSent", juce::var (sent));
+        object->setProperty ("messagesCoalesced", getMessagesCoalesced());
+        object->setProperty ("messagesDropped", getMessagesDropped());
+        object->setProperty ("outputQueueDepth", getOutputQueueDepth());
+        object->setProperty ("maxOutputQueueDepth", getMaxOutputQueueDepth());
+        object->setProperty ("processBlock", processBlockTime.toVar());
+        object->setProperty ("sysExSendLatency", sysExSendLatency.toVar());
+
+        return juce::JSON::toString (juce::var (object));
+    }
+
+private:
+    std::array<std::atomic<juce::int64>, numMessageTypes> messagesSent {};
+    std::atomic<juce::int64> messagesCoalesced { 0 };
+    std::atomic<juce::int64> messagesDropped { 0 };
+    std::atomic<int> outputQueueDepth { 0 };
+    std::atomic<int> maxOutputQueueDepth { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080Metrics)
+};
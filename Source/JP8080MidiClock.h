@@ -0,0 +1,200 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * MIDI clock for the synth's arpeggiator and tempo-synced delay
+ *
+ * Ticks (24 per quarter note) are placed on the sample where they fall in the
+ * host's timeline, worked out from the playhead's PPQ position and tempo at
+ * the start of each block. Start, Continue, Stop and Song Position Pointer
+ * follow the host transport; a jump or loop while playing goes out as Stop,
+ * Song Position Pointer, Continue. While the host is stopped, or without a
+ * host timeline, the clock keeps running at the current tempo so the delay
+ * stays in sync.
+ *
+ * Clock has priority on the wire: schedule() merges the ticks into the
+ * block's MidiBuffer and moves any other message that would still be going
+ * out over the 31250 baud port when a tick is due to just after that tick.
+ * Heavy knob traffic then delays CCs by a byte or two, never the clock.
+ */
+class JP8080MidiClock
+{
+public:
+    static constexpr int ticksPerQuarterNote = 24;
+    static constexpr int ticksPerSixteenth = ticksPerQuarterNote / 4;
+    static constexpr int maxEventsPerBlock = 256;
+
+    // Serial MIDI: 31250 baud, 10 bits per byte
+    static constexpr double bytesPerSecond = 31250.0 / 10.0;
+
+    struct Event
+    {
+        juce::MidiMessage message;
+        int sampleOffset;
+    };
+
+    using EventList = std::array<Event, maxEventsPerBlock>;
+
+    JP8080MidiClock() = default;
+
+    // Message thread, before processing starts
+    void prepare (int maximumExpectedEvents)
+    {
+        scheduled.ensureSize (static_cast<size_t> (maximumExpectedEvents) * 8);
+        reset();
+    }
+
+    // Start over: the next block realigns to the host and resends the transport state
+    void reset()
+    {
+        wasPlaying = false;
+        nextTick = -1;
+        clockPpq = 0.0;
+        wireBacklog = 0.0;
+    }
+
+    //==============================================================================
+    // Audio thread. Fills this block's clock and transport events in time
+    // order and returns how many there are. fallbackBpm is used when the
+    // host doesn't report a tempo.
+    int process (const juce::Optional<juce::AudioPlayHead::PositionInfo>& position, double fallbackBpm,
+                 int numSamples, double sampleRate, EventList& events)
+    {
+        if (sampleRate <= 0.0 || numSamples <= 0)
+            return 0;
+
+        double bpm = fallbackBpm;
+        if (position.hasValue())
+            if (auto hostBpm = position->getBpm())
+                bpm = *hostBpm;
+
+        const double ppqPerSample = juce::jlimit (20.0, 300.0, bpm) / 60.0 / sampleRate;
+
+        juce::Optional<double> hostPpq;
+        if (position.hasValue() && position->getIsPlaying())
+            hostPpq = position->getPpqPosition();
+
+        int numEvents = 0;
+
+        auto addEvent = [&] (const juce::MidiMessage& message, int sampleOffset)
+        {
+            if (numEvents < maxEventsPerBlock)
+                events[static_cast<size_t> (numEvents++)] = { message, sampleOffset };
+        };
+
+        if (hostPpq.hasValue())
+        {
+            const double ppq = *hostPpq;
+            const bool jumped = wasPlaying && std::abs (ppq - clockPpq) > 1.0 / ticksPerQuarterNote;
+
+            if (! wasPlaying || jumped)
+            {
+                if (jumped)
+                    addEvent (juce::MidiMessage::midiStop(), 0);
+
+                // Song Position Pointer counts sixteenths: resume on the next one
+                const auto sixteenth = static_cast<juce::int64> (std::ceil (juce::jmax (0.0, ppq) * 4.0 - 1.0e-9));
+
+                if (sixteenth == 0)
+                {
+                    addEvent (juce::MidiMessage::midiStart(), 0);
+                }
+                else
+                {
+                    addEvent (juce::MidiMessage::songPositionPointer (static_cast<int> (sixteenth & 0x3FFF)), 0);
+                    addEvent (juce::MidiMessage::midiContinue(), 0);
+                }
+
+                nextTick = sixteenth * ticksPerSixteenth;
+            }
+
+            // Lock to the host, which also takes up small tempo drift within a block
+            clockPpq = ppq;
+            wasPlaying = true;
+        }
+        else if (wasPlaying)
+        {
+            addEvent (juce::MidiMessage::midiStop(), 0);
+            wasPlaying = false;
+        }
+
+        if (nextTick < 0)
+            nextTick = static_cast<juce::int64> (std::ceil (clockPpq * ticksPerQuarterNote));
+
+        // Every tick that falls inside this block, at its own sample
+        for (;;)
+        {
+            const double tickPpq = static_cast<double> (nextTick) / ticksPerQuarterNote;
+            const double offset = (tickPpq - clockPpq) / ppqPerSample;
+
+            if (offset >= numSamples || numEvents >= maxEventsPerBlock)
+                break;
+
+            addEvent (juce::MidiMessage::midiClock(), juce::jmax (0, static_cast<int> (offset)));
+            ++nextTick;
+        }
+
+        clockPpq += numSamples * ppqPerSample;
+        return numEvents;
+    }
+
+    //==============================================================================
+    // Audio thread. Merges the events into midiMessages. Every other message
+    // keeps its order but starts no earlier than the wire is free, and is
+    // moved behind any tick that is due before it has been fully sent.
+    void schedule (juce::MidiBuffer& midiMessages, const EventList& events, int numEvents,
+                   int numSamples, double sampleRate)
+    {
+        if (numEvents == 0 && wireBacklog <= 0.0)
+            return;
+
+        const double samplesPerByte = sampleRate / bytesPerSecond;
+        double wireFreeAt = wireBacklog;
+        int nextEvent = 0;
+
+        scheduled.clear();
+
+        auto sendClockEvent = [&]
+        {
+            const auto& event = events[static_cast<size_t> (nextEvent++)];
+            scheduled.addEvent (event.message, event.sampleOffset);
+            wireFreeAt = juce::jmax (wireFreeAt, static_cast<double> (event.sampleOffset))
+                           + event.message.getRawDataSize() * samplesPerByte;
+        };
+
+        for (const auto metadata : midiMessages)
+        {
+            const double duration = metadata.numBytes * samplesPerByte;
+            double start = juce::jmax (static_cast<double> (metadata.samplePosition), wireFreeAt);
+
+            while (nextEvent < numEvents && events[static_cast<size_t> (nextEvent)].sampleOffset < start + duration)
+            {
+                sendClockEvent();
+                start = juce::jmax (start, wireFreeAt);
+            }
+
+            scheduled.addEvent (metadata.data, metadata.numBytes,
+                                juce::jmin (numSamples - 1, static_cast<int> (std::ceil (start))));
+            wireFreeAt = start + duration;
+        }
+
+        while (nextEvent < numEvents)
+            sendClockEvent();
+
+        // Bytes still going out when the block ends hold back the next block
+        wireBacklog = juce::jmax (0.0, wireFreeAt - numSamples);
+        midiMessages.swapWith (scheduled);
+    }
+
+private:
+    bool wasPlaying = false;
+    juce::int64 nextTick = -1;      // Index of the next tick, counted from PPQ 0
+    double clockPpq = 0.0;          // Clock position at the start of the next block
+    double wireBacklog = 0.0;       // Samples the port is still busy into the next block
+
+    juce::MidiBuffer scheduled;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080MidiClock)
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+
+//==============================================================================
+/**
+ * MIDI learn for incoming controllers, and the CC map used for output
+ *
+ * Receive: any parameter can be learned to a CC from a hardware controller
+ * on any channel. Routes live in a flat 16 x 128 table of parameter indices,
+ * so the audio thread finds the target of a CC with one atomic load. Learned
+ * CCs are taken out of the stream; everything else passes through to the
+ * synth as before.
+ *
+ * Transmit: the CC each knob parameter is sent on. It starts from the
+ * MODE2 assignments in JP8080Parameters and can be changed per instance to
+ * match the synth's Tx/Rx CC settings, or switched off for a parameter.
+ *
+ * Learning and editing happen on the message thread. While a parameter is
+ * armed, the audio thread only reports the next CC it sees; a short timer
+ * turns that into the route.
+ */
+class JP8080MidiLearn : private juce::Timer
+{
+public:
+    static constexpr int numChannels = 16;
+    static constexpr int numControllers = 128;
+    static constexpr int maxKnobParameters = 64;
+    static constexpr int learnPollIntervalMs = 30;
+
+    // Called on the message thread after the transmit map has changed
+    std::function<void()> onTransmitMapChanged;
+
+    explicit JP8080MidiLearn (juce::AudioProcessor& processorToControl)
+    {
+        for (auto* parameter : processorToControl.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+                parameters.push_back (ranged);
+
+        jassert (JP8080Parameters::getAllParameterIDs().size() <= maxKnobParameters);
+
+        for (auto& ccNumber : transmitCCs)
+            ccNumber = -1;
+
+        clearRoutes();
+        resetTransmitMap();
+        remappedParameters = 0;
+    }
+
+    ~JP8080MidiLearn() override
+    {
+        stopTimer();
+    }
+
+    //==============================================================================
+    // Message thread: learning
+    void startLearning (const juce::String& paramID)
+    {
+        learnedSlot = -1;
+        learningIndex = getParameterIndex (paramID);
+
+        if (learningIndex >= 0)
+            startTimer (learnPollIntervalMs);
+    }
+
+    void stopLearning()
+    {
+        learningIndex = -1;
+        stopTimer();
+    }
+
+    bool isLearning (const juce::String& paramID) const
+    {
+        const int index = learningIndex.load();
+        return index >= 0 && parameters[static_cast<size_t> (index)]->getParameterID() == paramID;
+    }
+
+    // Routes the controller to the parameter, replacing what either had before
+    void setRoute (int channel, int controller, const juce::String& paramID)
+    {
+        const int index = getParameterIndex (paramID);
+        if (index < 0 || ! isValidController (channel, controller))
+            return;
+
+        removeRoutes (paramID);
+        routes[static_cast<size_t> (getSlot (channel, controller))] = static_cast<int16_t> (index);
+    }
+
+    void removeRoutes (const juce::String& paramID)
+    {
+        const int index = getParameterIndex (paramID);
+
+        for (auto& route : routes)
+            if (route.load() == index)
+                route = -1;
+    }
+
+    void clearRoutes()
+    {
+        for (auto& route : routes)
+            route = -1;
+    }
+
+    // "Ch 1 CC 74", or empty when the parameter has no route
+    juce::String getRouteDescription (const juce::String& paramID) const
+    {
+        const int index = getParameterIndex (paramID);
+
+        for (int slot = 0; index >= 0 && slot < numChannels * numControllers; ++slot)
+            if (routes[static_cast<size_t> (slot)].load() == index)
+                return "Ch " + juce::String (slot / numControllers + 1) + " CC " + juce::String (slot % numControllers);
+
+        return {};
+    }
+
+    //==============================================================================
+    // Message thread: transmit map, -1 switches a parameter's CC off
+    void setTransmitCC (const juce::String& paramID, int ccNumber)
+    {
+        const int knobIndex = getKnobIndex (paramID);
+        if (knobIndex < 0)
+            return;
+
+        const auto value = static_cast<int8_t> (juce::jlimit (-1, 127, ccNumber));
+        if (transmitCCs[static_cast<size_t> (knobIndex)].exchange (value) == value)
+            return;
+
+        remappedParameters.fetch_or (uint64_t (1) << knobIndex);
+
+        if (onTransmitMapChanged != nullptr)
+            onTransmitMapChanged();
+    }
+
+    void resetTransmitMap()
+    {
+        const auto ids = JP8080Parameters::getAllParameterIDs();
+
+        for (size_t i = 0; i < ids.size(); ++i)
+            setTransmitCC (ids[i], JP8080Parameters::getCCNumber (ids[i]));
+    }
+
+    bool isDefaultTransmitCC (const juce::String& paramID) const
+    {
+        return getTransmitCC (paramID) == JP8080Parameters::getCCNumber (paramID);
+    }
+
+    //==============================================================================
+    // Plugin state: routes and the transmit CCs that differ from MODE2
+    juce::ValueTree toValueTree() const
+    {
+        juce::ValueTree tree ("MidiLearn");
+
+        for (int slot = 0; slot < numChannels * numControllers; ++slot)
+        {
+            const int index = routes[static_cast<size_t> (slot)].load();
+            if (index < 0)
+                continue;
+
+            juce::ValueTree route ("Route");
+            route.setProperty ("channel", slot / numControllers + 1, nullptr);
+            route.setProperty ("cc", slot % numControllers, nullptr);
+            route.setProperty ("id", parameters[static_cast<size_t> (index)]->getParameterID(), nullptr);
+            tree.appendChild (route, nullptr);
+        }
+
+        for (const auto& paramID : JP8080Parameters::getAllParameterIDs())
+        {
+            if (isDefaultTransmitCC (paramID))
+                continue;
+
+            juce::ValueTree transmit ("Transmit");
+            transmit.setProperty ("id", paramID, nullptr);
+            transmit.setProperty ("cc", getTransmitCC (paramID), nullptr);
+            tree.appendChild (transmit, nullptr);
+        }
+
+        return tree;
+    }
+
+    void fromValueTree (const juce::ValueTree& tree)
+    {
+        stopLearning();
+        clearRoutes();
+        resetTransmitMap();
+
+        for (const auto& child : tree)
+        {
+            const auto paramID = child.getProperty ("id").toString();
+
+            if (child.hasType ("Route"))
+                setRoute (child.getProperty ("channel", 0), child.getProperty ("cc", -1), paramID);
+            else if (child.hasType ("Transmit"))
+                setTransmitCC (paramID, child.getProperty ("cc", -1));
+        }
+    }
+
+    //==============================================================================
+    // Audio thread. Returns true when the CC was learned or routed, and
+    // should not go on to the synth.
+    bool handleControlChange (int channel, int controller, int value)
+    {
+        if (! isValidController (channel, controller))
+            return false;
+
+        const int slot = getSlot (channel, controller);
+
+        if (learningIndex.load() >= 0)
+        {
+            learnedSlot = slot;
+            return true;
+        }
+
+        const int index = routes[static_cast<size_t> (slot)].load();
+        if (index < 0)
+            return false;
+
+        auto* parameter = parameters[static_cast<size_t> (index)];
+        const float newValue = juce::jlimit (0, 127, value) / 127.0f;
+
+        if (parameter->getValue() != newValue)
+            parameter->setValueNotifyingHost (newValue);
+
+        return true;
+    }
+
+    // Any thread: the CC for a knob parameter, by getAllParameterIDs() index
+    int getTransmitCC (int knobIndex) const
+    {
+        return juce::isPositiveAndBelow (knobIndex, maxKnobParameters)
+                 ? transmitCCs[static_cast<size_t> (knobIndex)].load() : -1;
+    }
+
+    int getTransmitCC (const juce::String& paramID) const
+    {
+        return getTransmitCC (getKnobIndex (paramID));
+    }
+
+    // Audio thread: knob parameters whose CC changed since the last call, so
+    // their value can be sent again on the new CC
+    uint64_t takeRemappedParameters()           { return remappedParameters.exchange (0); }
+
+private:
+    static bool isValidController (int channel, int controller)
+    {
+        return channel >= 1 && channel <= numChannels && juce::isPositiveAndBelow (controller, numControllers);
+    }
+
+    static int getSlot (int channel, int controller)
+    {
+        return (channel - 1) * numControllers + controller;
+    }
+
+    int getParameterIndex (const juce::String& paramID) const
+    {
+        for (size_t i = 0; i < parameters.size(); ++i)
+            if (parameters[i]->getParameterID() == paramID)
+                return static_cast<int> (i);
+
+        return -1;
+    }
+
+    static int getKnobIndex (const juce::String& paramID)
+    {
+        static const std::map<juce::String, int> indices = []
+        {
+            std::map<juce::String, int> map;
+            const auto ids = JP8080Parameters::getAllParameterIDs();
+
+            for (size_t i = 0; i < ids.size(); ++i)
+                map[ids[i]] = static_cast<int> (i);
+
+            return map;
+        }();
+
+        auto it = indices.find (paramID);
+        return it != indices.end() ? it->second : -1;
+    }
+
+    // Message thread: turns the CC reported by the audio thread into the route
+    void timerCallback() override
+    {
+        const int slot = learnedSlot.exchange (-1);
+        const int index = learningIndex.load();
+
+        if (slot < 0 || index < 0)
+            return;
+
+        setRoute (slot / numControllers + 1, slot % numControllers, parameters[static_cast<size_t> (index)]->getParameterID());
+        stopLearning();
+    }
+
+    //==============================================================================
+    std::vector<juce::RangedAudioParameter*> parameters;
+
+    std::array<std::atomic<int16_t>, numChannels * numControllers> routes;
+    std::array<std::atomic<int8_t>, maxKnobParameters> transmitCCs;
+    std::atomic<uint64_t> remappedParameters { 0 };
+
+    std::atomic<int> learningIndex { -1 };
+    std::atomic<int> learnedSlot { -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080MidiLearn)
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+
+//==============================================================================
+/**
+ * Modulation matrix: velocity, aftertouch, mod wheel and key to knob parameters
+ *
+ * The sources follow the notes and controllers passing through the plugin:
+ * velocity and key hold the last note-on, aftertouch the last channel
+ * pressure and the mod wheel the last CC#1, on any channel. Key is bipolar
+ * around middle C.
+ *
+ * Once per block every slot's source is bent by its curve and scaled by its
+ * depth, and the results are summed per destination into an offset in MIDI
+ * steps. The slots are kept as one array per field, so this is a handful of
+ * straight loops over eight floats. The processor adds the offset to the
+ * knob value before its change detection, so a CC only goes out when the
+ * modulated 7-bit value actually changes.
+ */
+class JP8080ModMatrix
+{
+public:
+    static constexpr int numSlots = JP8080Parameters::ModMatrix::numSlots;
+    static constexpr int maxDestinations = 64;
+
+    enum Source
+    {
+        off = 0,
+        velocity,
+        aftertouch,
+        modWheel,
+        keyPosition,
+        numSources
+    };
+
+    explicit JP8080ModMatrix (juce::AudioProcessorValueTreeState& apvts)
+    {
+        using namespace JP8080Parameters::ModMatrix;
+
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            auto& parameters = slotParameters[static_cast<size_t> (slot)];
+            parameters.source = apvts.getParameter (getSourceID (slot));
+            parameters.destination = apvts.getParameter (getDestinationID (slot));
+            parameters.depth = apvts.getParameter (getDepthID (slot));
+            parameters.curve = apvts.getParameter (getCurveID (slot));
+        }
+
+        jassert (JP8080Parameters::getAllParameterIDs().size() < maxDestinations);
+
+        reset();
+    }
+
+    // Back to no notes and controllers at rest
+    void reset()
+    {
+        sourceValues.fill (0.0f);
+        offsets.fill (0.0f);
+    }
+
+    //==============================================================================
+    // Audio thread: follows the sources through this block's MIDI and
+    // recomputes every destination's offset
+    void process (const juce::MidiBuffer& midiMessages)
+    {
+        for (const auto metadata : midiMessages)
+        {
+            if (metadata.numBytes < 2)
+                continue;
+
+            const int status = metadata.data[0] & 0xF0;
+            const int data1 = metadata.data[1];
+            const int data2 = metadata.numBytes > 2 ? metadata.data[2] : 0;
+
+            if (status == 0x90 && data2 > 0)
+            {
+                sourceValues[velocity] = data2 / 127.0f;
+                sourceValues[keyPosition] = juce::jlimit (-1.0f, 1.0f, (data1 - 60) / 64.0f);
+            }
+            else if (status == 0xD0)
+            {
+                sourceValues[aftertouch] = data1 / 127.0f;
+            }
+            else if (status == 0xB0 && data1 == 1)
+            {
+                sourceValues[modWheel] = data2 / 127.0f;
+            }
+        }
+
+        // Slot settings, one array per field. Destination OFF goes to the
+        // unused last entry, so the sum below needs no branch.
+        for (size_t slot = 0; slot < numSlots; ++slot)
+        {
+            const auto& parameters = slotParameters[slot];
+
+            slotSource[slot] = getIndex (parameters.source, numSources);
+            slotDestination[slot] = getIndex (parameters.destination, maxDestinations) - 1;
+            slotDepth[slot] = getPlainValue (parameters.depth) * (127.0f / 100.0f);
+            slotCurve[slot] = getPlainValue (parameters.curve) * 0.01f;
+
+            if (slotDestination[slot] < 0 || slotSource[slot] == off)
+                slotDestination[slot] = maxDestinations - 1;
+        }
+
+        for (size_t slot = 0; slot < numSlots; ++slot)
+            slotInput[slot] = sourceValues[static_cast<size_t> (slotSource[slot])];
+
+        // Curve on the magnitude: -1 bends it to x^2, +1 to 2x - x^2, 0 is linear
+        for (size_t slot = 0; slot < numSlots; ++slot)
+        {
+            const float magnitude = std::abs (slotInput[slot]);
+            const float shaped = magnitude + slotCurve[slot] * magnitude * (1.0f - magnitude);
+            slotOutput[slot] = std::copysign (shaped, slotInput[slot]) * slotDepth[slot];
+        }
+
+        offsets.fill (0.0f);
+
+        for (size_t slot = 0; slot < numSlots; ++slot)
+            offsets[static_cast<size_t> (slotDestination[slot])] += slotOutput[slot];
+
+        offsets[maxDestinations - 1] = 0.0f;
+    }
+
+    // Audio thread: offset in MIDI steps for a knob parameter, by getAllParameterIDs() index
+    float getOffset (int knobIndex) const
+    {
+        return juce::isPositiveAndBelow (knobIndex, maxDestinations - 1) ? offsets[static_cast<size_t> (knobIndex)] : 0.0f;
+    }
+
+private:
+    struct SlotParameters
+    {
+        juce::RangedAudioParameter* source = nullptr;
+        juce::RangedAudioParameter* destination = nullptr;
+        juce::RangedAudioParameter* depth = nullptr;
+        juce::RangedAudioParameter* curve = nullptr;
+    };
+
+    static float getPlainValue (juce::RangedAudioParameter* parameter)
+    {
+        return parameter != nullptr ? parameter->convertFrom0to1 (parameter->getValue()) : 0.0f;
+    }
+
+    static int getIndex (juce::RangedAudioParameter* parameter, int limit)
+    {
+        return juce::jlimit (0, limit - 1, juce::roundToInt (getPlainValue (parameter)));
+    }
+
+    std::array<SlotParameters, numSlots> slotParameters;
+
+    // Audio thread
+    std::array<float, numSources> sourceValues;
+
+    std::array<int, numSlots> slotSource {};
+    std::array<int, numSlots> slotDestination {};
+    std::array<float, numSlots> slotDepth {};
+    std::array<float, numSlots> slotCurve {};
+    std::array<float, numSlots> slotInput {};
+    std::array<float, numSlots> slotOutput {};
+
+    std::array<float, maxDestinations> offsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080ModMatrix)
+};
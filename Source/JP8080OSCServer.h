@@ -0,0 +1,306 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Metrics.h"
+#include "JP8080LockSequencer.h"
+
+//==============================================================================
+/**
+ * OSC control endpoint for tablets and scripts
+ *
+ * Parameters are addressed by their IDs from JP8080Parameters.h, with plain
+ * values (0-127, or the index of a choice):
+ *
+ *   /jp8080/set <id> <value> [<id> <value> ...]     Any number of parameters per packet
+ *   /jp8080/subscribe <host> <port>                 Where replies go
+ *   /jp8080/lock <step> <id> <value>                Parameter lock on a sequencer step (0-63)
+ *   /jp8080/unlock <step> [<id>]                    One lock, or every lock on the step
+ *   /jp8080/locks <on> [<length>]                   Switches the lock sequencer, sets its length
+ *
+ * Incoming changes are queued lock-free by the receiver thread and applied
+ * by the audio thread at the start of the next block, one host notification
+ * per parameter however many changes arrived for it. Replies are coalesced:
+ * a fixed-rate timer sends one /jp8080/values <id> <value> ... message with
+ * the current value of everything that changed since the last reply, and
+ * the full state after a subscribe. Lock edits are handed to onLockEdit on
+ * the message thread.
+ */
+class JP8080OSCServer : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>,
+                        private juce::Timer
+{
+public:
+    static constexpr int replyRateHz = 20;
+
+    JP8080OSCServer (juce::AudioProcessor& processorToControl, JP8080Metrics& metricsToUse)
+        : metrics (metricsToUse)
+    {
+        for (auto* parameter : processorToControl.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter))
+            {
+                parameterIndices[ranged->getParameterID()] = static_cast<int> (parameters.size());
+                parameters.push_back (ranged);
+            }
+        }
+
+        jassert (parameters.size() <= maxParameters);
+        lastReplyValues.assign (parameters.size(), -1.0f);
+        latestValues.assign (parameters.size(), 0.0f);
+    }
+
+    ~JP8080OSCServer() override
+    {
+        stop();
+    }
+
+    //==============================================================================
+    // Message thread
+    bool start (int port)
+    {
+        stop();
+
+        if (! receiver.connect (port))
+            return false;
+
+        receiver.addListener (this);
+        listeningPort = port;
+        startTimerHz (replyRateHz);
+        return true;
+    }
+
+    void stop()
+    {
+        stopTimer();
+        receiver.removeListener (this);
+        receiver.disconnect();
+        sender.disconnect();
+        listeningPort = 0;
+    }
+
+    // 0 when not listening
+    int getPort() const                 { return listeningPort; }
+
+    // Message thread
+    std::function<void (const JP8080LockSequencer::Edit&)> onLockEdit;
+
+    //==============================================================================
+    // Audio thread: applies everything queued since the last block, latest value per parameter
+    void applyPendingChanges()
+    {
+        const auto scope = changeFifo.read (changeFifo.getNumReady());
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return;
+
+        std::bitset<maxParameters> changed;
+
+        auto collect = [&] (int start, int count)
+        {
+            for (int i = start; i < start + count; ++i)
+            {
+                const auto& change = changeBuffer[static_cast<size_t> (i)];
+                latestValues[static_cast<size_t> (change.index)] = change.value;
+                changed.set (static_cast<size_t> (change.index));
+            }
+        };
+
+        collect (scope.startIndex1, scope.blockSize1);
+        collect (scope.startIndex2, scope.blockSize2);
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+            if (changed[i])
+                parameters[i]->setValueNotifyingHost (latestValues[i]);
+    }
+
+private:
+    static constexpr size_t maxParameters = 128;
+    static constexpr int queueSize = 1024;
+
+    struct Change
+    {
+        int index;
+        float value;        // Normalised
+    };
+
+    //==============================================================================
+    // Receiver thread
+    void oscMessageReceived (const juce::OSCMessage& message) override
+    {
+        const auto address = message.getAddressPattern().toString();
+
+        if (address == "/jp8080/set")
+            queueChanges (message);
+        else if (address == "/jp8080/lock" || address == "/jp8080/unlock" || address == "/jp8080/locks")
+            queueLockEdit (address, message);
+        else if (address == "/jp8080/subscribe" && message.size() >= 2
+                 && message[0].isString() && message[1].isInt32())
+        {
+            const juce::ScopedLock sl (subscriberLock);
+            subscriberHost = message[0].getString();
+            subscriberPort = message[1].getInt32();
+            subscriberChanged = true;
+        }
+    }
+
+    void oscBundleReceived (const juce::OSCBundle& bundle) override
+    {
+        for (const auto& element : bundle)
+        {
+            if (element.isMessage())
+                oscMessageReceived (element.getMessage());
+            else if (element.isBundle())
+                oscBundleReceived (element.getBundle());
+        }
+    }
+
+    static bool getNumber (const juce::OSCArgument& argument, float& value)
+    {
+        if (argument.isFloat32())
+            value = argument.getFloat32();
+        else if (argument.isInt32())
+            value = static_cast<float> (argument.getInt32());
+        else
+            return false;
+
+        return true;
+    }
+
+    void queueChanges (const juce::OSCMessage& message)
+    {
+        for (int i = 0; i + 1 < message.size(); i += 2)
+        {
+            float value = 0.0f;
+
+            if (! message[i].isString() || ! getNumber (message[i + 1], value))
+                continue;
+
+            auto it = parameterIndices.find (message[i].getString());
+            if (it == parameterIndices.end())
+                continue;
+
+            const auto scope = changeFifo.write (1);
+
+            // Queue full: the audio thread isn't running
+            if (scope.blockSize1 < 1)
+            {
+                metrics.countDropped();
+                continue;
+            }
+
+            auto* parameter = parameters[static_cast<size_t> (it->second)];
+            changeBuffer[static_cast<size_t> (scope.startIndex1)] = { it->second, parameter->convertTo0to1 (value) };
+        }
+    }
+
+    void queueLockEdit (const juce::String& address, const juce::OSCMessage& message)
+    {
+        JP8080LockSequencer::Edit edit;
+        float number = 0.0f;
+
+        if (address == "/jp8080/locks")
+        {
+            if (message.size() < 1 || ! getNumber (message[0], edit.value))
+                return;
+
+            edit.type = JP8080LockSequencer::Edit::settings;
+            if (message.size() >= 2 && getNumber (message[1], number))
+                edit.step = juce::roundToInt (number);
+        }
+        else
+        {
+            if (message.size() < 1 || ! getNumber (message[0], number))
+                return;
+
+            edit.step = juce::roundToInt (number);
+            edit.type = address == "/jp8080/lock" ? JP8080LockSequencer::Edit::lock
+                                                  : JP8080LockSequencer::Edit::unlock;
+
+            if (message.size() >= 2 && message[1].isString())
+                edit.paramID = message[1].getString();
+
+            if (edit.type == JP8080LockSequencer::Edit::lock
+                 && (edit.paramID.isEmpty() || message.size() < 3 || ! getNumber (message[2], edit.value)))
+                return;
+        }
+
+        const juce::ScopedLock sl (lockEditLock);
+        pendingLockEdits.push_back (std::move (edit));
+    }
+
+    //==============================================================================
+    // Message thread: lock edits and coalesced replies
+    void timerCallback() override
+    {
+        std::vector<JP8080LockSequencer::Edit> lockEdits;
+        {
+            const juce::ScopedLock sl (lockEditLock);
+            lockEdits.swap (pendingLockEdits);
+        }
+
+        if (onLockEdit != nullptr)
+            for (const auto& edit : lockEdits)
+                onLockEdit (edit);
+
+        bool sendFullState = false;
+
+        {
+            const juce::ScopedLock sl (subscriberLock);
+
+            if (subscriberChanged)
+            {
+                subscriberChanged = false;
+                subscribed = sender.connect (subscriberHost, subscriberPort);
+                sendFullState = true;
+            }
+        }
+
+        if (! subscribed)
+            return;
+
+        juce::OSCMessage reply ("/jp8080/values");
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            const float value = parameters[i]->getValue();
+
+            if (value == lastReplyValues[i] && ! sendFullState)
+                continue;
+
+            lastReplyValues[i] = value;
+            reply.addString (parameters[i]->getParameterID());
+            reply.addFloat32 (parameters[i]->convertFrom0to1 (value));
+        }
+
+        if (! reply.isEmpty())
+            sender.send (reply);
+    }
+
+    //==============================================================================
+    JP8080Metrics& metrics;
+
+    std::vector<juce::RangedAudioParameter*> parameters;
+    std::map<juce::String, int> parameterIndices;       // Read-only after construction
+
+    juce::OSCReceiver receiver;
+    juce::OSCSender sender;
+    int listeningPort = 0;
+
+    // Receiver thread -> audio thread
+    juce::AbstractFifo changeFifo { queueSize };
+    std::array<Change, queueSize> changeBuffer {};
+    std::vector<float> latestValues;                    // Audio thread only
+
+    // Receiver thread -> message thread
+    juce::CriticalSection lockEditLock;
+    std::vector<JP8080LockSequencer::Edit> pendingLockEdits;
+
+    // Reply state
+    juce::CriticalSection subscriberLock;
+    juce::String subscriberHost;
+    int subscriberPort = 0;
+    bool subscriberChanged = false;
+    bool subscribed = false;                            // Message thread only
+    std::vector<float> lastReplyValues;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080OSCServer)
+};
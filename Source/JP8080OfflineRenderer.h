@@ -0,0 +1,341 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+ * Offline render of controller automation to a Standard MIDI File and .syx
+ *
+ * Drives processBlock() faster than real time over an automation timeline,
+ * without a host or a synth. Blocks are split at every automation point, so
+ * each change is processed at its exact sample position. The emitted
+ * MidiBuffer events, and the SysEx that would have gone to the hardware
+ * through the direct output, are collected into one MIDI track; the SysEx is
+ * also written to a .syx file.
+ *
+ * replay() runs the same timeline without writing files and reports every
+ * emitted byte with its sample position, for comparing two builds. A
+ * timeline can also restore a saved plugin state at a point in time and edit
+ * the lock sequencer, which plays against a 120 bpm transport from PPQ 0.
+ *
+ * Use a processor instance with no MIDI ports selected, so no live traffic
+ * (connection pings, patch requests) ends up in the render.
+ */
+class JP8080OfflineRenderer
+{
+public:
+    // value is in the parameter's own range: 0-127, or the index of a choice.
+    // With parameterID stateRestoreID the point restores state instead, with
+    // one of the lock edit IDs it applies lockEdit.
+    struct AutomationPoint
+    {
+        double timeSeconds;
+        juce::String parameterID;
+        float value;
+        juce::MemoryBlock state;
+        JP8080LockSequencer::Edit lockEdit {};
+    };
+
+    static inline const juce::String stateRestoreID { "@state" };
+    static inline const juce::String lockID { "@lock" };
+    static inline const juce::String unlockID { "@unlock" };
+    static inline const juce::String lockSettingsID { "@locks" };
+
+    // Every message from processBlock (direct = false) or the direct SysEx
+    // output (direct = true, F0 and F7 included), at its timeline sample
+    using EventCallback = std::function<void (juce::int64 samplePosition, const uint8_t* data, int size, bool direct)>;
+
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+        int numMidiEvents = 0;
+        int numSysExMessages = 0;
+        double renderMs = 0.0;
+    };
+
+    explicit JP8080OfflineRenderer (JP8080ControllerAudioProcessor& processorToRender)
+        : processor (processorToRender)
+    {
+    }
+
+    //==============================================================================
+    // Timeline as CSV lines of "time_seconds,parameter_id,value"; '#' starts a comment.
+    // "time_seconds,@state,file" restores a state saved by the plugin, or its
+    // XML, from a file relative to the CSV. Lock sequencer edits, as over OSC:
+    //   time_seconds,@lock,step,parameter_id,value
+    //   time_seconds,@unlock,step[,parameter_id]
+    //   time_seconds,@locks,on[,length]
+    static bool loadTimelineFromCSV (const juce::File& csvFile, std::vector<AutomationPoint>& timeline)
+    {
+        if (! csvFile.existsAsFile())
+            return false;
+
+        juce::StringArray lines;
+        csvFile.readLines (lines);
+
+        for (const auto& line : lines)
+        {
+            auto trimmed = line.trim();
+            if (trimmed.isEmpty() || trimmed.startsWithChar ('#'))
+                continue;
+
+            auto fields = juce::StringArray::fromTokens (trimmed, ",", "\"");
+            if (fields.size() < 3 || ! fields[0].trim().containsOnly ("0123456789.eE+-"))
+                continue;   // Header or malformed line
+
+            const auto parameterID = fields[1].trim();
+
+            if (parameterID == stateRestoreID)
+            {
+                juce::MemoryBlock state;
+                if (! loadState (csvFile.getParentDirectory().getChildFile (fields[2].trim()), state))
+                    return false;
+
+                timeline.push_back ({ fields[0].trim().getDoubleValue(), parameterID, 0.0f, std::move (state) });
+                continue;
+            }
+
+            if (parameterID == lockID || parameterID == unlockID || parameterID == lockSettingsID)
+            {
+                JP8080LockSequencer::Edit edit;
+
+                if (parameterID == lockSettingsID)
+                {
+                    edit.type = JP8080LockSequencer::Edit::settings;
+                    edit.value = fields[2].trim().getFloatValue();
+                    edit.step = fields.size() > 3 ? fields[3].trim().getIntValue() : -1;
+                }
+                else
+                {
+                    edit.type = parameterID == lockID ? JP8080LockSequencer::Edit::lock : JP8080LockSequencer::Edit::unlock;
+                    edit.step = fields[2].trim().getIntValue();
+                    edit.paramID = fields.size() > 3 ? fields[3].trim() : juce::String();
+
+                    if (edit.type == JP8080LockSequencer::Edit::lock)
+                    {
+                        if (fields.size() < 5)
+                            continue;   // Malformed line
+
+                        edit.value = fields[4].trim().getFloatValue();
+                    }
+                }
+
+                timeline.push_back ({ fields[0].trim().getDoubleValue(), parameterID, 0.0f, {}, std::move (edit) });
+                continue;
+            }
+
+            timeline.push_back ({ fields[0].trim().getDoubleValue(), parameterID, fields[2].trim().getFloatValue(), {} });
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    Result render (std::vector<AutomationPoint> timeline, double lengthSeconds,
+                   const juce::File& midiFile, const juce::File& syxFile,
+                   double sampleRate = 44100.0, int maxBlockSize = 512)
+    {
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        // 960 PPQ at the default 120 bpm: 1920 ticks per second
+        auto toTicks = [sampleRate] (juce::int64 samplePosition) { return static_cast<double> (samplePosition) * ticksPerSecond / sampleRate; };
+
+        juce::MidiMessageSequence sequence;
+        juce::MemoryOutputStream syxData;
+        int numMidiEvents = 0;
+        int numSysExMessages = 0;
+
+        auto result = replay (std::move (timeline), lengthSeconds,
+                              [&] (juce::int64 samplePosition, const uint8_t* data, int size, bool direct)
+        {
+            const juce::MidiMessage message (data, size);
+
+            if (direct)
+            {
+                sequence.addEvent (message, toTicks (juce::jmax (juce::int64 (0), samplePosition)));
+                syxData.write (data, static_cast<size_t> (size));
+                ++numSysExMessages;
+                return;
+            }
+
+            // A Standard MIDI File has no place for clock and transport messages
+            if (message.isMidiClock() || message.isMidiStart() || message.isMidiStop()
+                 || message.isMidiContinue() || message.isSongPositionPointer())
+                return;
+
+            sequence.addEvent (message, toTicks (samplePosition));
+            ++numMidiEvents;
+        }, sampleRate, maxBlockSize);
+
+        result.numMidiEvents = numMidiEvents;
+        result.numSysExMessages = numSysExMessages;
+
+        if (! result.ok)
+            return result;
+
+        result.ok = false;
+
+        sequence.sort();
+
+        juce::MidiFile midi;
+        midi.setTicksPerQuarterNote (ticksPerQuarterNote);
+        midi.addTrack (sequence);
+
+        {
+            juce::FileOutputStream output (midiFile);
+
+            if (! output.openedOk() || ! output.truncate().wasOk() || ! midi.writeTo (output))
+            {
+                result.error = "Could not write " + midiFile.getFileName();
+                return result;
+            }
+        }
+
+        if (syxFile != juce::File() && ! syxFile.replaceWithData (syxData.getData(), syxData.getDataSize()))
+        {
+            result.error = "Could not write " + syxFile.getFileName();
+            return result;
+        }
+
+        result.renderMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+        result.ok = true;
+        return result;
+    }
+
+    // Runs the timeline through processBlock and reports every emitted message
+    // in output order. Deterministic for a given timeline, sample rate and
+    // block size.
+    Result replay (std::vector<AutomationPoint> timeline, double lengthSeconds, const EventCallback& onEvent,
+                   double sampleRate = 44100.0, int maxBlockSize = 512)
+    {
+        Result result;
+
+        std::stable_sort (timeline.begin(), timeline.end(),
+                          [] (const AutomationPoint& a, const AutomationPoint& b) { return a.timeSeconds < b.timeSeconds; });
+
+        auto toSamples = [sampleRate] (double seconds) { return static_cast<juce::int64> (std::llround (seconds * sampleRate)); };
+
+        processor.setSysExCapture ([&] (const std::vector<uint8_t>& sysexData, juce::int64 samplePosition)
+        {
+            auto message = juce::MidiMessage::createSysExMessage (sysexData.data(), static_cast<int> (sysexData.size()));
+            onEvent (samplePosition, message.getRawData(), message.getRawDataSize(), true);
+        });
+
+        OfflinePlayHead playHead;
+        playHead.sampleRate = sampleRate;
+        processor.setPlayHead (&playHead);
+        processor.setNonRealtime (true);
+        processor.setRateAndBufferSizeDetails (sampleRate, maxBlockSize);
+        processor.prepareToPlay (sampleRate, maxBlockSize);
+
+        const int numChannels = juce::jmax (1, processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer (numChannels, maxBlockSize);
+        juce::MidiBuffer midiMessages;
+
+        const auto endPosition = toSamples (lengthSeconds);
+        juce::int64 position = 0;
+        size_t nextPoint = 0;
+
+        while (position < endPosition)
+        {
+            // Apply every change due at this position
+            while (nextPoint < timeline.size() && toSamples (timeline[nextPoint].timeSeconds) <= position)
+                applyAutomationPoint (timeline[nextPoint++], result);
+
+            // End the block at the next change, so it lands on its exact sample
+            auto blockEnd = juce::jmin (position + maxBlockSize, endPosition);
+            if (nextPoint < timeline.size())
+                blockEnd = juce::jmin (blockEnd, toSamples (timeline[nextPoint].timeSeconds));
+
+            const int numSamples = static_cast<int> (blockEnd - position);
+            buffer.setSize (numChannels, numSamples, false, false, true);
+            midiMessages.clear();
+            playHead.timeInSamples = position;
+
+            processor.processBlock (buffer, midiMessages);
+
+            for (const auto metadata : midiMessages)
+                onEvent (position + metadata.samplePosition, metadata.data, metadata.numBytes, false);
+
+            position = blockEnd;
+        }
+
+        processor.releaseResources();
+        processor.setPlayHead (nullptr);
+        processor.setSysExCapture (nullptr);
+
+        result.ok = result.error.isEmpty();
+        return result;
+    }
+
+private:
+    static constexpr int ticksPerQuarterNote = 960;
+    static constexpr double ticksPerSecond = ticksPerQuarterNote * 2.0;
+
+    // Reports the render position to processBlock, as a host transport would
+    struct OfflinePlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setTimeInSamples (timeInSamples);
+            info.setIsPlaying (true);
+            info.setBpm (bpm);
+            info.setPpqPosition (static_cast<double> (timeInSamples) / sampleRate * bpm / 60.0);
+            return info;
+        }
+
+        static constexpr double bpm = 120.0;
+        juce::int64 timeInSamples = 0;
+        double sampleRate = 44100.0;
+    };
+
+    // A state saved by getStateInformation(), or its XML as text
+    static bool loadState (const juce::File& file, juce::MemoryBlock& state)
+    {
+        if (! file.existsAsFile() || ! file.loadFileAsData (state))
+            return false;
+
+        if (auto xml = juce::parseXML (state.toString()))
+        {
+            state.reset();
+            juce::AudioProcessor::copyXmlToBinary (*xml, state);
+        }
+
+        return true;
+    }
+
+    void applyAutomationPoint (const AutomationPoint& point, Result& result)
+    {
+        // No message loop runs here: compile lock edits before the next block
+        if (point.parameterID == stateRestoreID)
+        {
+            processor.setStateInformation (point.state.getData(), static_cast<int> (point.state.getSize()));
+            processor.getLockSequencer().flushEdits();
+            return;
+        }
+
+        if (point.parameterID == lockID || point.parameterID == unlockID || point.parameterID == lockSettingsID)
+        {
+            processor.getLockSequencer().apply (point.lockEdit);
+            processor.getLockSequencer().flushEdits();
+            return;
+        }
+
+        auto* param = processor.getValueTreeState().getParameter (point.parameterID);
+
+        if (param == nullptr)
+        {
+            result.error = "Unknown parameter " + point.parameterID;
+            return;
+        }
+
+        param->setValueNotifyingHost (param->convertTo0to1 (point.value));
+    }
+
+    JP8080ControllerAudioProcessor& processor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080OfflineRenderer)
+};
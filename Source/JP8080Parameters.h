@@ -129,6 +129,127 @@ namespace JP8080Parameters
         static const juce::String patchProgram    = "patch_program";     // Program number (1-128)
     }
 
+    // ========== RPN (REGISTERED PARAMETER NUMBERS) ==========
+    // Sent as CC#101/100 (RPN MSB/LSB), CC#6/38 (Data Entry MSB/LSB), then RPN Null (7FH 7FH)
+    namespace RPN
+    {
+        static const juce::String bendRange       = "rpn_bend_range";    // RPN 00/00, 0-24 semitones
+        static const juce::String fineTune        = "rpn_fine_tune";     // RPN 00/01, -50 to +50 cents
+        static const juce::String coarseTune      = "rpn_coarse_tune";   // RPN 00/02, -24 to +24 semitones
+    }
+
+    struct RPNNumber
+    {
+        int msb;
+        int lsb;
+    };
+
+    static const std::map<juce::String, RPNNumber> rpnNumbers = {
+        {RPN::bendRange,  {0x00, 0x00}},
+        {RPN::fineTune,   {0x00, 0x01}},
+        {RPN::coarseTune, {0x00, 0x02}}
+    };
+
+    static constexpr int rpnNullMsb = 0x7F;
+    static constexpr int rpnNullLsb = 0x7F;
+
+    // ========== ARPEGGIATOR / TEMPO ==========
+    // Performance Common settings, sent as DT1 to the temporary performance (01 00 00 xx)
+    namespace Arpeggio
+    {
+        static const juce::String arpSwitch       = "arp_switch";        // 17H, OFF/ON
+        static const juce::String mode            = "arp_mode";          // 18H, UP - RPS
+        static const juce::String beatPattern     = "arp_beat_pattern";  // 19H, 90 beat patterns
+        static const juce::String range           = "arp_range";         // 1AH, 1-4 octaves
+        static const juce::String hold            = "arp_hold";          // 1BH, OFF/ON
+        static const juce::String tempo           = "arp_tempo";         // 22H (2 bytes), 20-250 BPM
+        static const juce::String midiClock       = "midi_clock";        // Send MIDI clock locked to the host
+    }
+
+    // Scene bank (see JP8080SceneBank.h), plugin-side only
+    namespace Scene
+    {
+        static const juce::String select          = "scene_select";      // OFF, 1-16: recalls the scene on change
+        static const juce::String fadeTime        = "scene_fade";        // Crossfade time in ms, 0 = instant
+        static const juce::String triggerChannel  = "scene_channel";     // Channel whose notes select scenes
+    }
+
+    // Notes C1 (36) to D#2 (51) on the trigger channel select scenes 1-16
+    static constexpr int sceneTriggerBaseNote = 36;
+
+    // Modulation matrix (see JP8080ModMatrix.h), plugin-side only. Every slot
+    // has a source, a knob parameter as destination, a depth and a curve.
+    namespace ModMatrix
+    {
+        static constexpr int numSlots = 8;
+
+        inline juce::String getSourceID(int slot)       { return "mod" + juce::String(slot + 1) + "_source"; }
+        inline juce::String getDestinationID(int slot)  { return "mod" + juce::String(slot + 1) + "_dest"; }
+        inline juce::String getDepthID(int slot)        { return "mod" + juce::String(slot + 1) + "_depth"; }   // -100 to +100 %
+        inline juce::String getCurveID(int slot)        { return "mod" + juce::String(slot + 1) + "_curve"; }   // -100 (exp) to +100 (log)
+    }
+
+    // Key is bipolar around middle C, the others run from 0 up
+    static const juce::StringArray modSourceNames = {
+        "OFF", "VELOCITY", "AFTERTOUCH", "MOD WHEEL", "KEY"
+    };
+
+    static const std::map<juce::String, int> performanceCommonOffsets = {
+        {Arpeggio::arpSwitch,   0x17},
+        {Arpeggio::mode,        0x18},
+        {Arpeggio::beatPattern, 0x19},
+        {Arpeggio::range,       0x1A},
+        {Arpeggio::hold,        0x1B},
+        {Arpeggio::tempo,       0x22}
+    };
+
+    static const juce::StringArray offOnNames = {
+        "OFF", "ON"
+    };
+
+    // Scene selector and trigger channel: OFF, then 1-16
+    static const juce::StringArray offOneToSixteenNames = {
+        "OFF", "1", "2", "3", "4", "5", "6", "7", "8",
+        "9", "10", "11", "12", "13", "14", "15", "16"
+    };
+
+    static const juce::StringArray arpModeNames = {
+        "UP", "DOWN", "UP&DOWN", "RANDOM", "RPS"
+    };
+
+    static const juce::StringArray arpRangeNames = {
+        "1 OCT", "2 OCT", "3 OCT", "4 OCT"
+    };
+
+    // Beat patterns 00H-59H, in the order of the synth's BEAT PATTERN list
+    static const juce::StringArray arpBeatPatternNames = [] {
+        juce::StringArray names { "1/4", "1/6", "1/8", "1/12", "1/16", "1/32" };
+
+        auto addNumbered = [&names](const juce::String& prefix, int count)
+        {
+            for (int i = 1; i <= count; ++i)
+                names.add(prefix + juce::String(i));
+        };
+
+        addNumbered("PORTA-A", 11);
+        addNumbered("PORTA-B", 15);
+        addNumbered("SEQUENCE-A", 7);
+        addNumbered("SEQUENCE-B", 5);
+        addNumbered("SEQUENCE-C", 2);
+        addNumbered("SEQUENCE-D", 8);
+        addNumbered("ECHO", 3);
+        addNumbered("MUTE", 16);
+        addNumbered("STRUMMING", 8);
+        addNumbered("REFRAIN", 2);
+        addNumbered("PERCUSSION", 4);
+        names.add("WALKING BASS");
+        names.add("HARP");
+        names.add("RANDOM");
+
+        jassert(names.size() == 90);
+        return names;
+    }();
+
     // Part selection options (for multi-instance support)
     static const juce::StringArray partNames = {
         "Upper",
@@ -383,6 +504,78 @@ namespace JP8080Parameters
         {Control::pan,                10}
     };
 
+    // ========== PATCH IMAGE OFFSETS ==========
+    // Byte offset of each parameter within the 248-byte patch image
+    // (Parameter Address Map, Patch section). Hold 1, Modulation, Expression
+    // and Pan are performance controllers and are not stored in the patch.
+    struct PatchOffsetInfo
+    {
+        int offset;     // Offset from the patch start address
+        int maxValue;   // Highest value stored in the patch
+    };
+
+    static const std::map<juce::String, PatchOffsetInfo> patchOffsets = {
+        // Oscillator
+        {Oscillator::osc1Waveform,    {0x1E, 6}},
+        {Oscillator::osc1Control1,    {0x1F, 127}},
+        {Oscillator::osc1Control2,    {0x20, 127}},
+        {Oscillator::osc2Waveform,    {0x21, 3}},
+        {Oscillator::osc2Range,       {0x23, 50}},
+        {Oscillator::osc2FineWide,    {0x24, 100}},
+        {Oscillator::osc2Control1,    {0x25, 127}},
+        {Oscillator::osc2Control2,    {0x26, 127}},
+        {Oscillator::oscBalance,      {0x17, 127}},
+        {Oscillator::xModDepth,       {0x16, 127}},
+        {Oscillator::oscLfo1Depth,    {0x19, 127}},
+
+        // Pitch Envelope
+        {PitchEnv::depth,             {0x1B, 127}},
+        {PitchEnv::attack,            {0x1C, 127}},
+        {PitchEnv::decay,             {0x1D, 127}},
+
+        // Filter
+        {Filter::cutoff,              {0x29, 127}},
+        {Filter::resonance,           {0x2A, 127}},
+        {Filter::keyFollow,           {0x2B, 127}},
+        {Filter::lfo1Depth,           {0x2C, 127}},
+        {Filter::envDepth,            {0x2E, 127}},
+        {Filter::envAttack,           {0x2F, 127}},
+        {Filter::envDecay,            {0x30, 127}},
+        {Filter::envSustain,          {0x31, 127}},
+        {Filter::envRelease,          {0x32, 127}},
+
+        // Amplifier
+        {Amplifier::level,            {0x33, 127}},
+        {Amplifier::lfo1Depth,        {0x34, 127}},
+        {Amplifier::envAttack,        {0x36, 127}},
+        {Amplifier::envDecay,         {0x37, 127}},
+        {Amplifier::envSustain,       {0x38, 127}},
+        {Amplifier::envRelease,       {0x39, 127}},
+
+        // LFO
+        {LFO::lfo1Waveform,           {0x10, 3}},
+        {LFO::lfo1Rate,               {0x11, 127}},
+        {LFO::lfo1Fade,               {0x12, 127}},
+        {LFO::lfo2Rate,               {0x13, 127}},
+        {LFO::lfo2PitchDepth,         {0x1A, 127}},
+        {LFO::lfo2FilterDepth,        {0x2D, 127}},
+        {LFO::lfo2AmpDepth,           {0x35, 127}},
+
+        // Effects
+        {Effects::toneCtrlBass,       {0x3B, 127}},
+        {Effects::toneCtrlTreble,     {0x3C, 127}},
+        {Effects::multiFxType,        {0x3D, 12}},
+        {Effects::multiFxLevel,       {0x3E, 127}},
+        {Effects::delayType,          {0x3F, 4}},
+        {Effects::delayTime,          {0x40, 127}},
+        {Effects::delayFeedback,      {0x41, 127}},
+        {Effects::delayLevel,         {0x42, 127}},
+
+        // Control
+        {Control::portamentoSwitch,   {0x45, 1}},
+        {Control::portamentoTime,     {0x46, 127}}
+    };
+
     // ========== PARAMETER DISPLAY NAMES ==========
     static const std::map<juce::String, juce::String> displayNames = {
         // Oscillator
@@ -452,7 +645,26 @@ namespace JP8080Parameters
         // MIDI Configuration
         {MidiConfig::part,            "Part"},
         {MidiConfig::patchBank,       "Patch Bank"},
-        {MidiConfig::patchProgram,    "Patch Program"}
+        {MidiConfig::patchProgram,    "Patch Program"},
+
+        // RPN
+        {RPN::bendRange,              "Pitch Bend Range"},
+        {RPN::fineTune,               "Master Fine Tune"},
+        {RPN::coarseTune,             "Master Coarse Tune"},
+
+        // Arpeggiator / Tempo
+        {Arpeggio::arpSwitch,         "Arpeggio Switch"},
+        {Arpeggio::mode,              "Arpeggio Mode"},
+        {Arpeggio::beatPattern,       "Arpeggio Beat Pattern"},
+        {Arpeggio::range,             "Arpeggio Range"},
+        {Arpeggio::hold,              "Arpeggio Hold"},
+        {Arpeggio::tempo,             "Tempo"},
+        {Arpeggio::midiClock,         "MIDI Clock Out"},
+
+        // Scenes
+        {Scene::select,               "Scene"},
+        {Scene::fadeTime,             "Scene Fade"},
+        {Scene::triggerChannel,       "Scene Trigger Channel"}
     };
 
     // Helper function to get CC number for a parameter ID
@@ -506,6 +718,61 @@ namespace JP8080Parameters
         };
     }
 
+    // RPN parameters, in the order they are sent
+    inline std::vector<juce::String> getAllRPNParameterIDs()
+    {
+        return { RPN::bendRange, RPN::fineTune, RPN::coarseTune };
+    }
+
+    // 14-bit Data Entry value (MSB << 7 | LSB) for a plain RPN parameter value
+    inline int getRPNDataValue(const juce::String& paramID, float plainValue)
+    {
+        if (paramID == RPN::bendRange)
+            return juce::jlimit(0, 24, juce::roundToInt(plainValue)) << 7;                         // 00H-18H, LSB ignored
+
+        if (paramID == RPN::coarseTune)
+            return (0x40 + juce::jlimit(-24, 24, juce::roundToInt(plainValue))) << 7;              // 28H-58H, LSB ignored
+
+        if (paramID == RPN::fineTune)
+            return juce::jlimit(0x1000, 0x3000, 0x2000 + juce::roundToInt(plainValue * 4096.0f / 50.0f)); // 20 00H - 60 00H
+
+        return 0;
+    }
+
+    // Modulation destinations: OFF, then the knob parameters in getAllParameterIDs() order
+    inline juce::StringArray getModDestinationNames()
+    {
+        juce::StringArray names { "OFF" };
+
+        for (const auto& paramID : getAllParameterIDs())
+            names.add(getDisplayName(paramID));
+
+        return names;
+    }
+
+    // Performance Common parameters, sent as SysEx when changed
+    inline std::vector<juce::String> getAllPerformanceCommonParameterIDs()
+    {
+        return { Arpeggio::arpSwitch, Arpeggio::mode, Arpeggio::beatPattern,
+                 Arpeggio::range, Arpeggio::hold, Arpeggio::tempo };
+    }
+
+    // DT1 data bytes for a Performance Common value, returning how many were
+    // written. Tempo is one of the two-byte ("#") addresses: upper bit first,
+    // then the lower 7 bits.
+    inline size_t getPerformanceCommonData(const juce::String& paramID, int value, std::array<uint8_t, 2>& data)
+    {
+        if (paramID == Arpeggio::tempo)
+        {
+            value = juce::jlimit(20, 250, value);
+            data = { static_cast<uint8_t>(value >> 7), static_cast<uint8_t>(value & 0x7F) };
+            return 2;
+        }
+
+        data[0] = static_cast<uint8_t>(juce::jlimit(0, 127, value));
+        return 1;
+    }
+
     // Helper function to check if parameter is a MIDI configuration (not a CC parameter)
     inline bool isMidiConfigParameter(const juce::String& paramID)
     {
@@ -514,5 +781,14 @@ namespace JP8080Parameters
                paramID == MidiConfig::patchProgram;
     }
 
-    // Total: 45 CC-controllable parameters + 3 MIDI config parameters = 48 total
+    inline bool isSceneParameter(const juce::String& paramID)
+    {
+        return paramID == Scene::select ||
+               paramID == Scene::fadeTime ||
+               paramID == Scene::triggerChannel;
+    }
+
+    // Total: 45 CC-controllable parameters + 3 MIDI config parameters + 3 RPN parameters
+    //        + 6 Performance Common parameters + MIDI clock switch + 3 scene parameters
+    //        + 8 x 4 modulation slot parameters = 93 total
 }
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * In-memory and on-disk cache of JP-8080 patch images
+ *
+ * Holds the 248-byte image of every patch in all 8 banks x 64 programs so a
+ * program change can update the parameters without a round trip to the
+ * hardware. Images are assembled from received DT1 data, validated with the
+ * Roland checksum and persisted to the user's application data folder. A
+ * slot being received again keeps serving its previous image until the new
+ * one is complete, so a patch can be re-read to catch edits written on the
+ * synth's front panel.
+ */
+class JP8080PatchCache
+{
+public:
+    static constexpr int numBanks = 8;
+    static constexpr int numPrograms = 64;
+    static constexpr int numSlots = numBanks * numPrograms;
+
+    using PatchImage = std::array<uint8_t, JP8080SysEx::patchSize>;
+
+    JP8080PatchCache()
+        : cacheFile (juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                        .getChildFile ("JP8080Controller")
+                        .getChildFile ("PatchCache.bin"))
+    {
+        loadFromFile();
+    }
+
+    //==============================================================================
+    // Slot access (bank = PatchBank index, program = 0-63)
+
+    bool isCached (int bank, int program) const
+    {
+        const juce::ScopedLock sl (lock);
+        auto* slot = getSlot (bank, program);
+        return slot != nullptr && slot->valid;
+    }
+
+    bool getPatch (int bank, int program, PatchImage& destImage) const
+    {
+        const juce::ScopedLock sl (lock);
+        auto* slot = getSlot (bank, program);
+
+        if (slot == nullptr || ! slot->valid)
+            return false;
+
+        // Guard against corruption after the image was stored
+        if (JP8080SysEx::calculateChecksum (slot->image.data(), slot->image.size()) != slot->checksum)
+            return false;
+
+        destImage = slot->image;
+        return true;
+    }
+
+    juce::String getPatchName (int bank, int program) const
+    {
+        PatchImage image;
+        if (! getPatch (bank, program, image))
+            return {};
+
+        // Patch name: 16 ASCII characters at offset 0x00
+        return juce::String (reinterpret_cast<const char*> (image.data()), 16).trimEnd();
+    }
+
+    int getNumCachedPatches() const
+    {
+        const juce::ScopedLock sl (lock);
+        return static_cast<int> (std::count_if (slots.begin(), slots.end(),
+                                                [] (const Slot& s) { return s.valid; }));
+    }
+
+    //==============================================================================
+    // Store received patch data. Partial writes are accumulated until the whole
+    // image has been received, which then replaces the slot's image. Returns
+    // true when this write completed an image.
+    bool writePatchData (int bank, int program, int offset, const uint8_t* data, int size)
+    {
+        const juce::ScopedLock sl (lock);
+        auto* slot = getSlot (bank, program);
+
+        if (slot == nullptr || offset < 0 || offset >= JP8080SysEx::patchSize)
+            return false;
+
+        size = juce::jmin (size, JP8080SysEx::patchSize - offset);
+
+        for (int i = 0; i < size; ++i)
+        {
+            slot->incoming[static_cast<size_t> (offset + i)] = data[i] & 0x7F;
+            slot->received.set (static_cast<size_t> (offset + i));
+        }
+
+        if (! slot->received.all())
+            return false;
+
+        if (! slot->valid || slot->incoming != slot->image)
+            dirty = true;
+
+        slot->image = slot->incoming;
+        slot->checksum = JP8080SysEx::calculateChecksum (slot->image.data(), slot->image.size());
+        slot->valid = true;
+        slot->received.reset();
+        return true;
+    }
+
+    // Drops partly received data before the slot is requested again; a complete
+    // image stays available until the new one has arrived
+    void restartCapture (int bank, int program)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (auto* slot = getSlot (bank, program))
+            slot->received.reset();
+    }
+
+    // Forget a slot's image
+    void invalidate (int bank, int program)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (auto* slot = getSlot (bank, program))
+        {
+            if (slot->valid)
+                dirty = true;
+
+            slot->valid = false;
+            slot->received.reset();
+        }
+    }
+
+    //==============================================================================
+    // Persistence
+    // File layout: magic, version, count, then count x (slot index, image, checksum)
+
+    bool loadFromFile()
+    {
+        juce::FileInputStream stream (cacheFile);
+
+        if (! stream.openedOk() || stream.readInt() != fileMagic || stream.readInt() != fileVersion)
+            return false;
+
+        const juce::ScopedLock sl (lock);
+        const int count = stream.readInt();
+
+        for (int i = 0; i < count && ! stream.isExhausted(); ++i)
+        {
+            const int slotIndex = stream.readShort();
+            PatchImage image;
+
+            if (stream.read (image.data(), static_cast<int> (image.size())) != static_cast<int> (image.size()))
+                break;
+
+            const auto checksum = static_cast<uint8_t> (stream.readByte());
+
+            // Skip entries that fail validation rather than rejecting the whole file
+            if (slotIndex < 0 || slotIndex >= numSlots
+                || JP8080SysEx::calculateChecksum (image.data(), image.size()) != checksum)
+                continue;
+
+            auto& slot = slots[static_cast<size_t> (slotIndex)];
+            slot.image = image;
+            slot.checksum = checksum;
+            slot.valid = true;
+        }
+
+        dirty = false;
+        return true;
+    }
+
+    bool saveToFile()
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (! dirty)
+            return true;
+
+        if (! cacheFile.getParentDirectory().createDirectory())
+            return false;
+
+        juce::TemporaryFile tempFile (cacheFile);
+
+        {
+            juce::FileOutputStream stream (tempFile.getFile());
+
+            if (! stream.openedOk())
+                return false;
+
+            stream.writeInt (fileMagic);
+            stream.writeInt (fileVersion);
+            stream.writeInt (std::count_if (slots.begin(), slots.end(), [] (const Slot& s) { return s.valid; }));
+
+            for (int i = 0; i < numSlots; ++i)
+            {
+                const auto& slot = slots[static_cast<size_t> (i)];
+
+                if (! slot.valid)
+                    continue;
+
+                stream.writeShort (static_cast<short> (i));
+                stream.write (slot.image.data(), slot.image.size());
+                stream.writeByte (static_cast<char> (slot.checksum));
+            }
+
+            stream.flush();
+
+            if (stream.getStatus().failed())
+                return false;
+        }
+
+        if (! tempFile.overwriteTargetFileWithTemporary())
+            return false;
+
+        dirty = false;
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        PatchImage image {};
+        PatchImage incoming {};                         // Being received
+        std::bitset<JP8080SysEx::patchSize> received;   // Bytes of incoming so far
+        uint8_t checksum = 0;
+        bool valid = false;
+    };
+
+    static constexpr int fileMagic = 0x4A503843; // "JP8C"
+    static constexpr int fileVersion = 1;
+
+    Slot* getSlot (int bank, int program)
+    {
+        if (! juce::isPositiveAndBelow (bank, numBanks) || ! juce::isPositiveAndBelow (program, numPrograms))
+            return nullptr;
+
+        return &slots[static_cast<size_t> (bank * numPrograms + program)];
+    }
+
+    const Slot* getSlot (int bank, int program) const
+    {
+        return const_cast<JP8080PatchCache*> (this)->getSlot (bank, program);
+    }
+
+    std::array<Slot, numSlots> slots;
+    bool dirty = false;
+    juce::CriticalSection lock;
+    juce::File cacheFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080PatchCache)
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+
+//==============================================================================
+/**
+ * Sends the RPN parameters (bend range, fine and coarse tuning)
+ *
+ * Every changed RPN goes out as CC#101/100/6/38, and the group ends with one
+ * RPN Null, so later Data Entry messages can't land on a live RPN. The whole
+ * unit is built in one go and added to the MidiBuffer at a single sample
+ * position, so no other CC on the channel can end up inside it.
+ *
+ * Only RPNs whose value differs from what was last sent are included.
+ * Consecutive edits (a knob being dragged) are batched: the unit is held
+ * until the values stop moving for a block, or for at most maxBatchMs.
+ */
+class JP8080RPNSequencer
+{
+public:
+    struct ControlChange
+    {
+        int controller;
+        int value;
+    };
+
+    static constexpr int numRPNs = 3;
+    static constexpr int maxUnitSize = numRPNs * 4 + 2;
+    using Unit = std::array<ControlChange, maxUnitSize>;
+
+    static constexpr double maxBatchMs = 50.0;
+
+    explicit JP8080RPNSequencer (juce::AudioProcessorValueTreeState& apvts)
+    {
+        for (const auto& paramID : JP8080Parameters::getAllRPNParameterIDs())
+            entries.push_back ({ paramID, apvts.getParameter (paramID), JP8080Parameters::rpnNumbers.at (paramID) });
+
+        jassert (entries.size() == numRPNs);
+    }
+
+    // Forget what was sent, so every RPN goes out with the next unit
+    void reset()
+    {
+        for (auto& entry : entries)
+            entry.lastSentValue = -1;
+    }
+
+    //==============================================================================
+    // Audio thread. Builds the unit due in this block and returns its size
+    // (0 when there is nothing to send yet).
+    int process (int channel, int numSamples, double sampleRate, Unit& unit)
+    {
+        // The other part's channel has its own RPN state on the synth
+        if (channel != lastChannel)
+        {
+            reset();
+            lastChannel = channel;
+        }
+
+        bool moved = false;
+        bool pending = false;
+
+        for (auto& entry : entries)
+        {
+            if (entry.parameter == nullptr)
+                continue;
+
+            const int value = JP8080Parameters::getRPNDataValue (entry.paramID,
+                                  entry.parameter->convertFrom0to1 (entry.parameter->getValue()));
+
+            moved = moved || value != entry.currentValue;
+            pending = pending || value != entry.lastSentValue;
+            entry.currentValue = value;
+        }
+
+        if (! pending)
+        {
+            pendingSamples = 0;
+            return 0;
+        }
+
+        // Wait for the edit to settle, so a drag costs one unit rather than one per block
+        pendingSamples += numSamples;
+        if (moved && pendingSamples < static_cast<juce::int64> (maxBatchMs * 0.001 * sampleRate))
+            return 0;
+
+        int size = 0;
+
+        for (auto& entry : entries)
+        {
+            if (entry.parameter == nullptr || entry.currentValue == entry.lastSentValue)
+                continue;
+
+            unit[static_cast<size_t> (size++)] = { 101, entry.number.msb };
+            unit[static_cast<size_t> (size++)] = { 100, entry.number.lsb };
+            unit[static_cast<size_t> (size++)] = { 6, (entry.currentValue >> 7) & 0x7F };
+            unit[static_cast<size_t> (size++)] = { 38, entry.currentValue & 0x7F };
+            entry.lastSentValue = entry.currentValue;
+        }
+
+        unit[static_cast<size_t> (size++)] = { 101, JP8080Parameters::rpnNullMsb };
+        unit[static_cast<size_t> (size++)] = { 100, JP8080Parameters::rpnNullLsb };
+
+        pendingSamples = 0;
+        return size;
+    }
+
+private:
+    struct Entry
+    {
+        juce::String paramID;
+        juce::RangedAudioParameter* parameter;
+        JP8080Parameters::RPNNumber number;
+        int currentValue = -1;
+        int lastSentValue = -1;
+    };
+
+    std::vector<Entry> entries;
+    int lastChannel = -1;
+    juce::int64 pendingSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080RPNSequencer)
+};
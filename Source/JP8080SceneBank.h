@@ -0,0 +1,206 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+
+//==============================================================================
+/**
+ * Scene bank for live sets: up to 16 complete sounds per instance
+ *
+ * A scene holds the normalised value of every sound parameter (everything
+ * but part, patch selection, clock output and the scene controls). Scenes
+ * are stored from the message thread and recalled from the audio thread, so
+ * each value is an atomic float and a recall never waits.
+ *
+ * A recall either sets every value at once, and the processor sends the
+ * difference to what the synth last received as one compiled burst, or
+ * starts a crossfade: continuous parameters then move linearly to the scene
+ * over the fade time, one update per block, and go out through the step
+ * emitter within the port's bandwidth. Switches and selectors change at the
+ * start of the fade.
+ */
+class JP8080SceneBank
+{
+public:
+    static constexpr int numScenes = 16;
+
+    explicit JP8080SceneBank (juce::AudioProcessor& processorToControl)
+    {
+        using namespace JP8080Parameters;
+
+        for (auto* parameter : processorToControl.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter);
+            if (ranged == nullptr)
+                continue;
+
+            const auto id = ranged->getParameterID();
+            if (isMidiConfigParameter (id) || id == Arpeggio::midiClock || isSceneParameter (id))
+                continue;
+
+            parameters.push_back ({ ranged, dynamic_cast<juce::AudioParameterFloat*> (ranged) != nullptr });
+        }
+
+        for (auto& scene : scenes)
+            scene.values = std::make_unique<std::atomic<float>[]> (parameters.size());
+
+        fadeStartValues.resize (parameters.size());
+    }
+
+    //==============================================================================
+    // Message thread
+    void storeScene (int sceneIndex)
+    {
+        if (! juce::isPositiveAndBelow (sceneIndex, numScenes))
+            return;
+
+        auto& scene = scenes[static_cast<size_t> (sceneIndex)];
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+            scene.values[i].store (parameters[i].parameter->getValue());
+
+        scene.stored = true;
+    }
+
+    void clearScene (int sceneIndex)
+    {
+        if (juce::isPositiveAndBelow (sceneIndex, numScenes))
+            scenes[static_cast<size_t> (sceneIndex)].stored = false;
+    }
+
+    bool hasScene (int sceneIndex) const
+    {
+        return juce::isPositiveAndBelow (sceneIndex, numScenes) && scenes[static_cast<size_t> (sceneIndex)].stored;
+    }
+
+    //==============================================================================
+    // Plugin state: values by parameter ID, so scenes survive new parameters
+    juce::ValueTree toValueTree() const
+    {
+        juce::ValueTree tree ("Scenes");
+
+        for (int i = 0; i < numScenes; ++i)
+        {
+            const auto& scene = scenes[static_cast<size_t> (i)];
+            if (! scene.stored)
+                continue;
+
+            juce::ValueTree sceneTree ("Scene");
+            sceneTree.setProperty ("index", i, nullptr);
+
+            for (size_t p = 0; p < parameters.size(); ++p)
+                sceneTree.setProperty (parameters[p].parameter->getParameterID(), scene.values[p].load(), nullptr);
+
+            tree.appendChild (sceneTree, nullptr);
+        }
+
+        return tree;
+    }
+
+    void fromValueTree (const juce::ValueTree& tree)
+    {
+        for (auto& scene : scenes)
+            scene.stored = false;
+
+        for (const auto& sceneTree : tree)
+        {
+            const int index = sceneTree.getProperty ("index", -1);
+            if (! sceneTree.hasType ("Scene") || ! juce::isPositiveAndBelow (index, numScenes))
+                continue;
+
+            auto& scene = scenes[static_cast<size_t> (index)];
+
+            for (size_t p = 0; p < parameters.size(); ++p)
+            {
+                auto* parameter = parameters[p].parameter;
+                scene.values[p].store (sceneTree.getProperty (parameter->getParameterID(), parameter->getDefaultValue()));
+            }
+
+            scene.stored = true;
+        }
+    }
+
+    //==============================================================================
+    // Audio thread. Returns false if the scene is empty. Without a fade the
+    // values are set at once and the caller sends them as a jump.
+    bool recall (int sceneIndex, double fadeMs, double sampleRate)
+    {
+        if (! hasScene (sceneIndex))
+            return false;
+
+        const auto& scene = scenes[static_cast<size_t> (sceneIndex)];
+        const bool fade = fadeMs > 0.0 && sampleRate > 0.0;
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            auto& entry = parameters[i];
+            fadeStartValues[i] = entry.parameter->getValue();
+
+            if (! fade || ! entry.isContinuous)
+                setIfChanged (entry.parameter, scene.values[i].load());
+        }
+
+        fadeScene = fade ? sceneIndex : -1;
+        fadeLengthSamples = fade ? juce::jmax (1.0, fadeMs * 0.001 * sampleRate) : 0.0;
+        fadePositionSamples = 0.0;
+        return true;
+    }
+
+    // Audio thread: moves a crossfade on by one block. Returns true while one is running.
+    bool process (int numSamples)
+    {
+        if (fadeScene < 0)
+            return false;
+
+        fadePositionSamples += numSamples;
+        const float amount = static_cast<float> (juce::jmin (1.0, fadePositionSamples / fadeLengthSamples));
+        const auto& scene = scenes[static_cast<size_t> (fadeScene)];
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            if (! parameters[i].isContinuous)
+                continue;
+
+            const float start = fadeStartValues[i];
+            setIfChanged (parameters[i].parameter, start + (scene.values[i].load() - start) * amount);
+        }
+
+        if (amount >= 1.0f)
+            fadeScene = -1;
+
+        return true;
+    }
+
+    // Audio thread: leaves the parameters where a running crossfade has got to
+    void cancelFade()                   { fadeScene = -1; }
+
+private:
+    struct Entry
+    {
+        juce::RangedAudioParameter* parameter;
+        bool isContinuous;
+    };
+
+    struct StoredScene
+    {
+        std::unique_ptr<std::atomic<float>[]> values;
+        std::atomic<bool> stored { false };
+    };
+
+    static void setIfChanged (juce::RangedAudioParameter* parameter, float value)
+    {
+        if (parameter->getValue() != value)
+            parameter->setValueNotifyingHost (value);
+    }
+
+    std::vector<Entry> parameters;
+    std::array<StoredScene, numScenes> scenes;
+
+    // Audio thread
+    std::vector<float> fadeStartValues;
+    int fadeScene = -1;
+    double fadeLengthSamples = 0.0;
+    double fadePositionSamples = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080SceneBank)
+};
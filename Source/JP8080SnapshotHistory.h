@@ -0,0 +1,318 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080Parameters.h"
+
+//==============================================================================
+/**
+ * Undo history and A/B compare for the sound parameters
+ *
+ * A snapshot is a persistent array of the normalised parameter values, split
+ * into small fixed-size chunks held by shared pointer. Taking a snapshot after
+ * a change copies only the chunks that changed and shares the rest with the
+ * previous one, so the A/B slots and the committed state cost a few chunks
+ * between them. Undo steps are stored as index -> (before, after) deltas:
+ * a knob tweak is one 12-byte entry, and thousands of steps fit in kilobytes.
+ *
+ * Steps follow the edit gestures (knob drags, combo selections): everything
+ * that changed between the first gesture starting and the last one ending is
+ * one step. Changes made without a gesture (host automation, OSC, patch
+ * recall) are folded into the committed state without becoming steps.
+ *
+ * Undo, redo and A/B switches only set the parameters whose values differ,
+ * so the processor's change detection sends just that delta.
+ *
+ * Everything here runs on the message thread, apart from the gesture
+ * callbacks, which only flag work for it.
+ */
+class JP8080SnapshotHistory : private juce::AudioProcessorParameter::Listener,
+                              private juce::AsyncUpdater,
+                              private juce::Timer
+{
+public:
+    static constexpr int chunkSize = 8;
+    static constexpr size_t maxUndoSteps = 10000;
+    static constexpr int rebaseIntervalMs = 200;
+
+    // Called after undo, redo or an A/B switch has set its values. The
+    // processor sends those as jumps rather than sweeping to them.
+    std::function<void()> onValuesRecalled;
+
+    explicit JP8080SnapshotHistory (juce::AudioProcessor& processorToTrack)
+    {
+        for (auto* parameter : processorToTrack.getParameters())
+        {
+            auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (parameter);
+
+            // Part, patch selection, clock output and scenes are setup, not sound
+            if (ranged == nullptr
+                 || JP8080Parameters::isMidiConfigParameter (ranged->getParameterID())
+                 || JP8080Parameters::isSceneParameter (ranged->getParameterID())
+                 || ranged->getParameterID() == JP8080Parameters::Arpeggio::midiClock)
+                continue;
+
+            parameters.push_back (ranged);
+            ranged->addListener (this);
+        }
+
+        committed = capture();
+        slots[0] = slots[1] = committed;
+
+        startTimer (rebaseIntervalMs);
+    }
+
+    ~JP8080SnapshotHistory() override
+    {
+        stopTimer();
+        cancelPendingUpdate();
+
+        for (auto* parameter : parameters)
+            parameter->removeListener (this);
+    }
+
+    //==============================================================================
+    bool canUndo() const                { return ! undoSteps.empty(); }
+    bool canRedo() const                { return ! redoSteps.empty(); }
+    int getNumUndoSteps() const         { return static_cast<int> (undoSteps.size()); }
+
+    void undo()
+    {
+        commitPendingChanges();
+
+        if (undoSteps.empty())
+            return;
+
+        auto step = std::move (undoSteps.back());
+        undoSteps.pop_back();
+
+        applyStep (step, false);
+        redoSteps.push_back (std::move (step));
+    }
+
+    void redo()
+    {
+        commitPendingChanges();
+
+        if (redoSteps.empty())
+            return;
+
+        auto step = std::move (redoSteps.back());
+        redoSteps.pop_back();
+
+        applyStep (step, true);
+        undoSteps.push_back (std::move (step));
+    }
+
+    void clearHistory()
+    {
+        undoSteps.clear();
+        redoSteps.clear();
+    }
+
+    //==============================================================================
+    // A/B compare: edits go to the active slot, switching recalls the other one
+    int getActiveSlot() const           { return activeSlot; }
+
+    void switchSlot()
+    {
+        commitPendingChanges();
+
+        slots[static_cast<size_t> (activeSlot)] = committed;
+        activeSlot = 1 - activeSlot;
+
+        // Recalling the other sound is itself an undoable step
+        recall (slots[static_cast<size_t> (activeSlot)]);
+    }
+
+    // Makes the inactive slot a copy of the current sound
+    void copyToOtherSlot()
+    {
+        commitPendingChanges();
+        slots[static_cast<size_t> (1 - activeSlot)] = committed;
+    }
+
+    //==============================================================================
+    // Bytes held by the history and snapshots, counting shared chunks once
+    size_t getMemoryUsage() const
+    {
+        size_t bytes = 0;
+
+        for (const auto* steps : { &undoSteps, &redoSteps })
+            for (const auto& step : *steps)
+                bytes += sizeof (Step) + step.deltas.capacity() * sizeof (Delta);
+
+        std::set<const Chunk*> chunks;
+        for (const auto* snapshot : { &committed, &slots[0], &slots[1] })
+            for (const auto& chunk : *snapshot)
+                chunks.insert (chunk.get());
+
+        return bytes + chunks.size() * sizeof (Chunk);
+    }
+
+private:
+    using Chunk = std::array<float, chunkSize>;
+    using Snapshot = std::vector<std::shared_ptr<const Chunk>>;
+
+    struct Delta
+    {
+        uint16_t index;
+        float before;
+        float after;
+    };
+
+    struct Step
+    {
+        std::vector<Delta> deltas;
+    };
+
+    //==============================================================================
+    float getSnapshotValue (const Snapshot& snapshot, size_t index) const
+    {
+        return (*snapshot[index / chunkSize])[index % chunkSize];
+    }
+
+    // Current values, sharing every chunk that still matches the committed state
+    Snapshot capture() const
+    {
+        Snapshot snapshot;
+        const size_t numChunks = (parameters.size() + chunkSize - 1) / chunkSize;
+        snapshot.reserve (numChunks);
+
+        for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex)
+        {
+            Chunk values {};
+            for (size_t i = 0; i < chunkSize && chunkIndex * chunkSize + i < parameters.size(); ++i)
+                values[i] = parameters[chunkIndex * chunkSize + i]->getValue();
+
+            if (chunkIndex < committed.size() && *committed[chunkIndex] == values)
+                snapshot.push_back (committed[chunkIndex]);
+            else
+                snapshot.push_back (std::make_shared<const Chunk> (values));
+        }
+
+        return snapshot;
+    }
+
+    //==============================================================================
+    // Turns everything changed since the last commit into one undo step, or
+    // folds it in silently when no gesture has ended since
+    void commitPendingChanges()
+    {
+        if (! commitPending.exchange (false))
+        {
+            committed = capture();
+            return;
+        }
+
+        auto current = capture();
+        Step step;
+
+        for (size_t index = 0; index < parameters.size(); ++index)
+        {
+            const float before = getSnapshotValue (committed, index);
+            const float after = getSnapshotValue (current, index);
+
+            if (before != after)
+                step.deltas.push_back ({ static_cast<uint16_t> (index), before, after });
+        }
+
+        committed = std::move (current);
+
+        if (step.deltas.empty())
+            return;
+
+        step.deltas.shrink_to_fit();
+        pushUndoStep (std::move (step));
+    }
+
+    void pushUndoStep (Step&& step)
+    {
+        undoSteps.push_back (std::move (step));
+        redoSteps.clear();
+
+        if (undoSteps.size() > maxUndoSteps)
+            undoSteps.pop_front();
+    }
+
+    // Sets only the parameters whose values differ from the committed state
+    void recall (const Snapshot& target)
+    {
+        Step step;
+
+        for (size_t index = 0; index < parameters.size(); ++index)
+        {
+            const float before = getSnapshotValue (committed, index);
+            const float after = getSnapshotValue (target, index);
+
+            if (before != after)
+                step.deltas.push_back ({ static_cast<uint16_t> (index), before, after });
+        }
+
+        if (step.deltas.empty())
+            return;
+
+        step.deltas.shrink_to_fit();
+        applyStep (step, true);
+        pushUndoStep (std::move (step));
+    }
+
+    void applyStep (const Step& step, bool forward)
+    {
+        for (const auto& delta : step.deltas)
+            parameters[delta.index]->setValueNotifyingHost (forward ? delta.after : delta.before);
+
+        if (onValuesRecalled != nullptr)
+            onValuesRecalled();
+
+        committed = capture();
+    }
+
+    //==============================================================================
+    void parameterValueChanged (int, float) override {}
+
+    // Any thread: gestures only count, the step is taken on the message thread
+    void parameterGestureChanged (int, bool gestureIsStarting) override
+    {
+        if (gestureIsStarting)
+        {
+            ++gesturesInProgress;
+            return;
+        }
+
+        if (--gesturesInProgress <= 0)
+        {
+            gesturesInProgress = 0;
+            commitPending = true;
+            triggerAsyncUpdate();
+        }
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (gesturesInProgress == 0)
+            commitPendingChanges();
+    }
+
+    // Folds changes made without a gesture into the committed state, so the
+    // next step holds only what that gesture changed
+    void timerCallback() override
+    {
+        if (gesturesInProgress == 0 && ! commitPending)
+            commitPendingChanges();
+    }
+
+    //==============================================================================
+    std::vector<juce::RangedAudioParameter*> parameters;
+
+    Snapshot committed;
+    std::array<Snapshot, 2> slots;
+    int activeSlot = 0;
+
+    std::deque<Step> undoSteps;
+    std::deque<Step> redoSteps;
+
+    std::atomic<int> gesturesInProgress { 0 };
+    std::atomic<bool> commitPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080SnapshotHistory)
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace JP8080StepEmitter
+{
+    // Step-exact CC emission for continuous parameters
+    //
+    // The parameters run at full float resolution (0.0-127.0); the synth only
+    // takes 7-bit values. Between two blocks the value is taken to move
+    // linearly across the block, and every 7-bit step it passes is sent at
+    // the sample where the value crosses that step's rounding threshold
+    // (k - 0.5 going up, k + 0.5 going down). A sweep therefore costs exactly
+    // one message per audible step, each at the right time.
+
+    // Serial MIDI: 31250 baud, 10 bits per byte, 3 bytes per CC
+    static constexpr double ccMessagesPerSecond = 31250.0 / 10.0 / 3.0;
+
+    struct Step
+    {
+        int value;
+        int sampleOffset;
+    };
+
+    static constexpr int maxStepsPerBlock = 128;
+    using StepList = std::array<Step, maxStepsPerBlock>;
+
+    // Rounds a plain value to the 7-bit value sent for it
+    inline int toMidiValue (float plainValue)
+    {
+        return juce::jlimit (0, 127, juce::roundToInt (plainValue));
+    }
+
+    // CC messages the port can carry in one block
+    inline int getBlockBudget (double sampleRate, int numSamples)
+    {
+        return sampleRate > 0.0 ? juce::jmax (1, static_cast<int> (ccMessagesPerSecond * numSamples / sampleRate))
+                                : maxStepsPerBlock;
+    }
+
+    // Plans the steps from lastSentValue (-1 if unknown) to the value of
+    // targetValue, for a value that moved from previousValue to targetValue
+    // over numSamples. At most maxSteps steps are returned, spread evenly
+    // over the ones crossed; the final value is always the last step.
+    inline int planSteps (int lastSentValue, float previousValue, float targetValue,
+                          int numSamples, int maxSteps, StepList& steps)
+    {
+        const int targetMidiValue = toMidiValue (targetValue);
+
+        if (lastSentValue == targetMidiValue)
+            return 0;
+
+        maxSteps = juce::jlimit (1, maxStepsPerBlock, maxSteps);
+
+        // Nothing to interpolate from: jump straight to the target
+        if (lastSentValue < 0 || previousValue == targetValue)
+        {
+            steps[0] = { targetMidiValue, 0 };
+            return 1;
+        }
+
+        const int direction = targetMidiValue > lastSentValue ? 1 : -1;
+        const int numCrossed = std::abs (targetMidiValue - lastSentValue);
+        const int numSteps = juce::jmin (numCrossed, maxSteps);
+        const float range = targetValue - previousValue;
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            // Evenly thinned when over budget, always ending on the target
+            const int crossed = (i + 1) * numCrossed / numSteps;
+            const int value = lastSentValue + direction * crossed;
+            const float threshold = static_cast<float> (value) - 0.5f * static_cast<float> (direction);
+
+            const float position = (threshold - previousValue) / range;
+            const int offset = juce::jlimit (0, juce::jmax (0, numSamples - 1), static_cast<int> (position * static_cast<float> (numSamples)));
+
+            steps[static_cast<size_t> (i)] = { value, offset };
+        }
+
+        return numSteps;
+    }
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace JP8080SysEx
+{
+    // Roland exclusive message framing for the JP-8080
+    // F0 41 dev 00 06 cmd aa bb cc dd [data | size] sum F7
+    // (MIDI Implementation, section 3 and 4)
+
+    // ========== MESSAGE HEADER ==========
+    static constexpr uint8_t rolandId         = 0x41;
+    static constexpr uint8_t defaultDeviceId  = 0x10;  // Device ID 17 (factory setting)
+    static constexpr uint8_t modelIdMsb       = 0x00;
+    static constexpr uint8_t modelIdLsb       = 0x06;  // JP-8080
+    static constexpr uint8_t commandRQ1       = 0x11;  // Data Request 1
+    static constexpr uint8_t commandDT1       = 0x12;  // Data Set 1
+
+    // Header bytes preceding the address (excluding F0)
+    static constexpr int headerSize = 5;
+    static constexpr int addressSize = 4;
+
+    // ========== ADDRESS MAP ==========
+    // Addresses are four 7-bit bytes. Offsets are added in 7-bit arithmetic,
+    // so a 248-byte patch at 01 00 40 00 ends at 01 00 41 77.
+    using Address = std::array<uint8_t, addressSize>;
+
+    static constexpr int patchSize = 248;           // Patch size: 00 00 01 78
+    static constexpr int numUserPatches = 128;      // User A11 - B88
+    static constexpr int numUserPerformances = 64;  // User 11 - 88
+
+    inline int addressToInt (const Address& address)
+    {
+        return (address[0] << 21) | (address[1] << 14) | (address[2] << 7) | address[3];
+    }
+
+    inline Address intToAddress (int value)
+    {
+        return { static_cast<uint8_t>((value >> 21) & 0x7F),
+                 static_cast<uint8_t>((value >> 14) & 0x7F),
+                 static_cast<uint8_t>((value >> 7) & 0x7F),
+                 static_cast<uint8_t>(value & 0x7F) };
+    }
+
+    // Temporary patch of the performance: Upper 01 00 40 00, Lower 01 00 42 00
+    inline Address getTemporaryPatchAddress (int partIndex)
+    {
+        return { 0x01, 0x00, static_cast<uint8_t>(partIndex == 0 ? 0x40 : 0x42), 0x00 };
+    }
+
+    // Performance Common of the temporary performance: 01 00 00 00 + offset
+    inline Address getTemporaryPerformanceCommonAddress (int offset)
+    {
+        return { 0x01, 0x00, 0x00, static_cast<uint8_t>(offset & 0x7F) };
+    }
+
+    // User patch area: 02 00 00 00 + (patch number * 00 00 02 00)
+    inline Address getUserPatchAddress (int patchIndex)
+    {
+        patchIndex = juce::jlimit (0, numUserPatches - 1, patchIndex);
+        return { 0x02, static_cast<uint8_t>(patchIndex / 64), static_cast<uint8_t>((patchIndex % 64) * 2), 0x00 };
+    }
+
+    // User performance area: 03 pp 00 00
+    inline Address getUserPerformanceAddress (int performanceIndex)
+    {
+        performanceIndex = juce::jlimit (0, numUserPerformances - 1, performanceIndex);
+        return { 0x03, static_cast<uint8_t>(performanceIndex), 0x00, 0x00 };
+    }
+
+    // Blocks making up a performance, as (7-bit offset from the performance start, size)
+    struct PerformanceBlock
+    {
+        int offset;
+        int size;
+    };
+
+    static constexpr std::array<PerformanceBlock, 6> performanceBlocks = {{
+        { 0x00 << 7, 0x25 },        // Performance Common
+        { 0x08 << 7, 0x29 },        // Voice Modulator
+        { 0x10 << 7, 0x08 },        // Part Upper
+        { 0x11 << 7, 0x08 },        // Part Lower
+        { 0x40 << 7, patchSize },   // Patch Upper
+        { 0x42 << 7, patchSize }    // Patch Lower
+    }};
+
+    // Decode an address inside the user patch area into patch index and byte offset
+    inline bool decodeUserPatchAddress (const Address& address, int& patchIndex, int& offset)
+    {
+        if (address[0] != 0x02 || address[1] > 0x01)
+            return false;
+
+        patchIndex = address[1] * 64 + address[2] / 2;
+        offset = (address[2] % 2) * 128 + address[3];
+        return offset < patchSize;
+    }
+
+    // Decode an address inside a temporary patch into part index (0 = Upper, 1 = Lower) and byte offset
+    inline bool decodeTemporaryPatchAddress (const Address& address, int& partIndex, int& offset)
+    {
+        if (address[0] != 0x01 || address[1] != 0x00 || address[2] < 0x40 || address[2] > 0x43)
+            return false;
+
+        partIndex = (address[2] < 0x42) ? 0 : 1;
+        offset = (address[2] % 2) * 128 + address[3];
+        return offset < patchSize;
+    }
+
+    // ========== CHECKSUM ==========
+    // Roland checksum: sum address and data bytes, checksum = 128 - (sum mod 128)
+    inline uint8_t calculateChecksum (const uint8_t* data, size_t size)
+    {
+        int sum = 0;
+        for (size_t i = 0; i < size; ++i)
+            sum += data[i];
+
+        return static_cast<uint8_t>((128 - (sum % 128)) & 0x7F);
+    }
+
+    // ========== MESSAGE CONSTRUCTION ==========
+    // Messages are built WITHOUT F0/F7, matching juce::MidiMessage::createSysExMessage
+
+    // Builds into an existing vector, so reserved capacity avoids allocating
+    inline void writeDataSet (uint8_t deviceId, const Address& address,
+                              const uint8_t* data, size_t size, std::vector<uint8_t>& message)
+    {
+        message.clear();
+        message.insert (message.end(), { rolandId, deviceId, modelIdMsb, modelIdLsb, commandDT1 });
+        message.insert (message.end(), address.begin(), address.end());
+        message.insert (message.end(), data, data + size);
+        message.push_back (calculateChecksum (message.data() + headerSize, addressSize + size));
+    }
+
+    inline std::vector<uint8_t> createDataSet (uint8_t deviceId, const Address& address,
+                                               const uint8_t* data, size_t size)
+    {
+        std::vector<uint8_t> message;
+        writeDataSet (deviceId, address, data, size, message);
+        return message;
+    }
+
+    inline std::vector<uint8_t> createDataRequest (uint8_t deviceId, const Address& address, int size)
+    {
+        auto sizeBytes = intToAddress (size);
+
+        std::vector<uint8_t> message = { rolandId, deviceId, modelIdMsb, modelIdLsb, commandRQ1 };
+        message.insert (message.end(), address.begin(), address.end());
+        message.insert (message.end(), sizeBytes.begin(), sizeBytes.end());
+        message.push_back (calculateChecksum (message.data() + headerSize, addressSize * 2));
+        return message;
+    }
+
+    // ========== IDENTITY ==========
+    // Universal Non-realtime Identity Request / Reply (MIDI Implementation, section 2)
+    static constexpr uint8_t broadcastDeviceId = 0x7F;
+    static constexpr uint8_t minDeviceId = 0x10;    // Device ID 17
+    static constexpr uint8_t maxDeviceId = 0x1F;    // Device ID 32
+
+    inline std::vector<uint8_t> createIdentityRequest (uint8_t deviceId = broadcastDeviceId)
+    {
+        return { 0x7E, deviceId, 0x06, 0x01 };
+    }
+
+    // Identity Reply: 7E dev 06 02 41 06 01 00 01 00 02 00 00 (without F0/F7).
+    // Returns the replying device ID for a JP-8080.
+    inline bool parseIdentityReply (const uint8_t* sysexData, int sysexSize, uint8_t& deviceId)
+    {
+        if (sysexData == nullptr || sysexSize < 13)
+            return false;
+
+        if (sysexData[0] != 0x7E || sysexData[2] != 0x06 || sysexData[3] != 0x02
+            || sysexData[4] != rolandId || sysexData[5] != 0x06 || sysexData[6] != 0x01)
+            return false;
+
+        deviceId = sysexData[1];
+        return true;
+    }
+
+    // ========== MESSAGE PARSING ==========
+    // A received DT1 message. The data pointer refers into the caller's buffer.
+    struct DataSet
+    {
+        uint8_t deviceId = defaultDeviceId;
+        Address address {};
+        const uint8_t* data = nullptr;
+        int size = 0;
+    };
+
+    // Parse a DT1 message given the SysEx body without F0/F7 (as returned by
+    // juce::MidiMessage::getSysExData). Returns false for other messages or a bad checksum.
+    inline bool parseDataSet (const uint8_t* sysexData, int sysexSize, DataSet& result)
+    {
+        // Header + address + at least one data byte + checksum
+        if (sysexData == nullptr || sysexSize < headerSize + addressSize + 2)
+            return false;
+
+        if (sysexData[0] != rolandId || sysexData[2] != modelIdMsb
+            || sysexData[3] != modelIdLsb || sysexData[4] != commandDT1)
+            return false;
+
+        const int checkedSize = sysexSize - headerSize - 1;
+        if (calculateChecksum (sysexData + headerSize, static_cast<size_t>(checkedSize)) != sysexData[sysexSize - 1])
+            return false;
+
+        result.deviceId = sysexData[1];
+        std::copy (sysexData + headerSize, sysexData + headerSize + addressSize, result.address.begin());
+        result.data = sysexData + headerSize + addressSize;
+        result.size = checkedSize - addressSize;
+        return true;
+    }
+}
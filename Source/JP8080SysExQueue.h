@@ -0,0 +1,116 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * Hands SysEx from the audio thread to a sender thread
+ *
+ * The MIDI output is guarded by a lock that other threads hold for a whole
+ * sendMessageNow() (a bulk dump, a cache fill) or while they reopen the
+ * device, so the audio thread must never take it. Instead it copies each
+ * message into a preallocated slot of a single-producer ring, which the
+ * sender thread polls every millisecond and passes on in order. Waking the
+ * thread would signal a WaitableEvent, and that takes a mutex, so the audio
+ * thread doesn't. A full ring or a message longer than a slot is refused and
+ * the caller counts a drop.
+ */
+class JP8080SysExQueue : private juce::Thread
+{
+public:
+    static constexpr int numSlots = 64;
+    static constexpr int pollIntervalMs = 1;
+    static constexpr int maxMessageSize = 512;      // Larger than any single DT1 we build
+
+    // Sender thread. queuedTicks is when the message was pushed.
+    using SendFunction = std::function<void (const std::vector<uint8_t>& sysexData, juce::int64 samplePosition,
+                                             int parameterIndex, juce::int64 queuedTicks)>;
+
+    explicit JP8080SysExQueue (SendFunction sendFunction)
+        : juce::Thread ("JP-8080 SysEx Sender"),
+          send (std::move (sendFunction))
+    {
+        pending.reserve (maxMessageSize);
+        startThread();
+    }
+
+    ~JP8080SysExQueue() override
+    {
+        stop();
+    }
+
+    // Sends nothing more; anything still queued is discarded
+    void stop()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (2000);
+    }
+
+    //==============================================================================
+    // Audio thread only. Doesn't lock, allocate or wake the sender; false if
+    // the message was refused.
+    bool push (const std::vector<uint8_t>& sysexData, juce::int64 samplePosition, int parameterIndex)
+    {
+        if (sysexData.empty() || sysexData.size() > static_cast<size_t> (maxMessageSize))
+            return false;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        auto& slot = slots[static_cast<size_t> (size1 > 0 ? start1 : start2)];
+        std::copy (sysexData.begin(), sysexData.end(), slot.data.begin());
+        slot.size = static_cast<int> (sysexData.size());
+        slot.samplePosition = samplePosition;
+        slot.parameterIndex = parameterIndex;
+        slot.queuedTicks = juce::Time::getHighResolutionTicks();
+
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        std::array<uint8_t, maxMessageSize> data {};
+        int size = 0;
+        juce::int64 samplePosition = -1;
+        int parameterIndex = -1;
+        juce::int64 queuedTicks = 0;
+    };
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (pollIntervalMs);
+
+            while (! threadShouldExit() && fifo.getNumReady() > 0)
+            {
+                int start1, size1, start2, size2;
+                fifo.prepareToRead (1, start1, size1, start2, size2);
+
+                const auto& slot = slots[static_cast<size_t> (size1 > 0 ? start1 : start2)];
+                pending.assign (slot.data.begin(), slot.data.begin() + slot.size);
+                const auto samplePosition = slot.samplePosition;
+                const auto parameterIndex = slot.parameterIndex;
+                const auto queuedTicks = slot.queuedTicks;
+                fifo.finishedRead (1);
+
+                send (pending, samplePosition, parameterIndex, queuedTicks);
+            }
+        }
+    }
+
+    SendFunction send;
+
+    // AbstractFifo keeps one slot free to tell full from empty
+    juce::AbstractFifo fifo { numSlots + 1 };
+    std::array<Slot, numSlots + 1> slots;
+    std::vector<uint8_t> pending;                   // Sender thread only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080SysExQueue)
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "JP8080SysEx.h"
+
+//==============================================================================
+/**
+ * Streaming SysEx reassembler for data received from the JP-8080
+ *
+ * Accepts raw MIDI bytes in arbitrary chunks: a whole message, a fragment of
+ * one, or several back to back. Complete messages are validated in place in
+ * the caller's buffer; only fragments are copied, into a fixed buffer, so
+ * receiving never allocates. Valid JP-8080 DT1 messages are passed to the
+ * listener as address/data spans, valid only for the duration of the call.
+ */
+class JP8080SysExReassembler
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        // dataSet spans point into sysexData (the message body without F0/F7)
+        virtual void handleDataSet (const JP8080SysEx::DataSet& dataSet,
+                                    const uint8_t* sysexData, int sysexSize) = 0;
+    };
+
+    // Largest DT1 the JP-8080 sends: 256 data bytes plus header, address and checksum
+    static constexpr int maxMessageSize = 512;
+
+    explicit JP8080SysExReassembler (Listener& listenerToUse)
+        : listener (listenerToUse)
+    {
+    }
+
+    void setDeviceId (uint8_t newDeviceId)      { deviceId = newDeviceId; }
+    uint8_t getDeviceId() const                 { return deviceId.load(); }
+
+    int getNumValidMessages() const             { return numValidMessages.load(); }
+    int getNumRejectedMessages() const          { return numRejectedMessages.load(); }
+
+    // Drop any partially received message (e.g. when the input device changes)
+    void reset()
+    {
+        inSysEx = false;
+        bufferSize = 0;
+        overflowed = false;
+    }
+
+    //==============================================================================
+    // Feed raw MIDI bytes, called from a single MIDI input thread
+    void processBytes (const uint8_t* data, int size)
+    {
+        int pos = 0;
+
+        while (pos < size)
+        {
+            const uint8_t byte = data[pos];
+
+            // Realtime messages may be interleaved anywhere, even inside SysEx
+            if (byte >= 0xF8)
+            {
+                ++pos;
+                continue;
+            }
+
+            if (byte == 0xF0)
+            {
+                reset();
+
+                // Fast path: the whole message is in this chunk, validate it in place
+                int end = pos + 1;
+                while (end < size && data[end] < 0x80)
+                    ++end;
+
+                if (end < size && data[end] == 0xF7)
+                {
+                    dispatch (data + pos + 1, end - pos - 1);
+                    pos = end + 1;
+                    continue;
+                }
+
+                inSysEx = true;
+                ++pos;
+                continue;
+            }
+
+            if (! inSysEx)
+            {
+                ++pos;
+                continue;
+            }
+
+            if (byte == 0xF7)
+            {
+                if (! overflowed)
+                    dispatch (buffer.data(), bufferSize);
+                else
+                    ++numRejectedMessages;
+
+                reset();
+                ++pos;
+                continue;
+            }
+
+            if (byte >= 0x80)
+            {
+                // Any other status byte terminates the SysEx without F7
+                ++numRejectedMessages;
+                reset();
+                continue;
+            }
+
+            // Copy the run of data bytes up to the next status byte in one go
+            int end = pos;
+            while (end < size && data[end] < 0x80)
+                ++end;
+
+            const int runLength = end - pos;
+
+            if (bufferSize + runLength <= maxMessageSize)
+            {
+                std::memcpy (buffer.data() + bufferSize, data + pos, static_cast<size_t> (runLength));
+                bufferSize += runLength;
+            }
+            else
+            {
+                overflowed = true;
+            }
+
+            pos = end;
+        }
+    }
+
+private:
+    void dispatch (const uint8_t* sysexData, int sysexSize)
+    {
+        JP8080SysEx::DataSet dataSet;
+
+        // Checks the Roland/JP-8080 header, DT1 command and checksum without copying
+        if (! JP8080SysEx::parseDataSet (sysexData, sysexSize, dataSet) || dataSet.deviceId != deviceId.load())
+        {
+            ++numRejectedMessages;
+            return;
+        }
+
+        ++numValidMessages;
+        listener.handleDataSet (dataSet, sysexData, sysexSize);
+    }
+
+    Listener& listener;
+    std::atomic<uint8_t> deviceId { JP8080SysEx::defaultDeviceId };
+
+    std::array<uint8_t, maxMessageSize> buffer {};
+    int bufferSize = 0;
+    bool inSysEx = false;
+    bool overflowed = false;
+
+    std::atomic<int> numValidMessages { 0 };
+    std::atomic<int> numRejectedMessages { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080SysExReassembler)
+};
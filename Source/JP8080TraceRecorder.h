@@ -0,0 +1,392 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+ * In-process trace of all MIDI traffic to and from the JP-8080
+ *
+ * Every thread that sends or receives writes into a fixed ring of records
+ * without locks or allocation: a writer reserves its records with a single
+ * fetch_add and publishes each one with a sequence number. Messages longer
+ * than one record's payload span consecutive records. A background thread
+ * drains the ring into a binary .jp8trace file; when recording stops the
+ * trace is also converted to CSV and to a Standard MIDI File next to it.
+ *
+ * If the flush thread falls a full ring behind, the overwritten records are
+ * counted as lost rather than blocking the writers.
+ */
+class JP8080TraceRecorder : private juce::Thread
+{
+public:
+    enum Direction : uint8_t
+    {
+        outgoing = 0,
+        incoming = 1
+    };
+
+    JP8080TraceRecorder()
+        : juce::Thread ("JP-8080 Trace Writer")
+    {
+    }
+
+    ~JP8080TraceRecorder() override
+    {
+        // Let a running conversion finish rather than leave truncated files
+        stop();
+        stopThread (10000);
+    }
+
+    //==============================================================================
+    // Message thread. Fails while the previous trace is still being converted.
+    bool start (const juce::File& traceFile, double sampleRate)
+    {
+        if (isThreadRunning())
+            return false;
+
+        traceFile.getParentDirectory().createDirectory();
+        stream = std::make_unique<juce::FileOutputStream> (traceFile);
+
+        if (! stream->openedOk() || ! stream->truncate().wasOk())
+        {
+            stream.reset();
+            return false;
+        }
+
+        file = traceFile;
+        readIndex = writeIndex.load();
+        lostRecords = 0;
+        startTicks = juce::Time::getHighResolutionTicks();
+
+        stream->writeInt (fileMagic);
+        stream->writeInt (fileVersion);
+        stream->writeInt64 (juce::Time::currentTimeMillis());
+        stream->writeDouble (sampleRate);
+
+        recording = true;
+        return startThread();
+    }
+
+    // Doesn't block: the writer thread flushes and converts the trace, then exits
+    void stop()
+    {
+        recording = false;
+        signalThreadShouldExit();
+        notify();
+    }
+
+    // True while a previous trace is still being written or converted
+    bool isBusy() const                         { return isThreadRunning(); }
+
+    bool isRecording() const                    { return recording.load(); }
+    juce::File getFile() const                  { return file; }
+    juce::int64 getLostRecords() const          { return lostRecords.load(); }
+
+    //==============================================================================
+    // Any thread, wait-free. samplePosition is the host timeline position of the
+    // message (-1 if it wasn't sent from processBlock); parameterIndex is the
+    // index of the parameter that caused it (-1 if none).
+    void record (Direction direction, const uint8_t* data, int size,
+                 juce::int64 samplePosition = -1, int parameterIndex = -1)
+    {
+        if (! recording.load (std::memory_order_relaxed) || size <= 0)
+            return;
+
+        size = juce::jmin (size, maxMessageSize);
+
+        const auto micros = ticksToMicros (juce::Time::getHighResolutionTicks() - startTicks.load (std::memory_order_relaxed));
+        const int numRecords = (size + payloadSize - 1) / payloadSize;
+        const auto first = writeIndex.fetch_add (static_cast<uint64_t> (numRecords), std::memory_order_relaxed);
+
+        for (int i = 0; i < numRecords; ++i)
+        {
+            const auto index = first + static_cast<uint64_t> (i);
+            auto& r = records[index & indexMask];
+
+            // Invalidate first, so a reader never accepts a half-written record
+            r.sequence.store (0, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+
+            r.wallClockMicros = micros;
+            r.samplePosition = samplePosition;
+            r.parameterIndex = static_cast<int16_t> (parameterIndex);
+            r.direction = direction;
+            r.totalSize = static_cast<uint16_t> (size);
+            r.chunkIndex = static_cast<uint16_t> (i);
+
+            const int offset = i * payloadSize;
+            std::memcpy (r.payload.data(), data + offset, static_cast<size_t> (juce::jmin (payloadSize, size - offset)));
+
+            r.sequence.store (index + 1, std::memory_order_release);
+        }
+    }
+
+    //==============================================================================
+    // Offline conversion of a .jp8trace file
+    struct Event
+    {
+        juce::int64 wallClockMicros;
+        juce::int64 samplePosition;
+        int parameterIndex;
+        Direction direction;
+        std::vector<uint8_t> bytes;
+    };
+
+    static bool readTraceFile (const juce::File& traceFile, std::vector<Event>& events,
+                               juce::int64& startTimeMillis, double& sampleRate)
+    {
+        juce::FileInputStream input (traceFile);
+
+        if (! input.openedOk() || input.readInt() != fileMagic || input.readInt() != fileVersion)
+            return false;
+
+        startTimeMillis = input.readInt64();
+        sampleRate = input.readDouble();
+
+        while (! input.isExhausted())
+        {
+            Event event;
+            event.wallClockMicros = input.readInt64();
+            event.samplePosition = input.readInt64();
+            event.parameterIndex = input.readShort();
+            event.direction = static_cast<Direction> (input.readByte());
+
+            const int size = input.readShort() & 0xffff;
+            event.bytes.resize (static_cast<size_t> (size));
+
+            if (input.read (event.bytes.data(), size) != size)
+                break;
+
+            events.push_back (std::move (event));
+        }
+
+        return true;
+    }
+
+    static bool convertToCSV (const juce::File& traceFile, const juce::File& csvFile)
+    {
+        std::vector<Event> events;
+        juce::int64 startTimeMillis = 0;
+        double sampleRate = 0.0;
+
+        if (! readTraceFile (traceFile, events, startTimeMillis, sampleRate))
+            return false;
+
+        juce::FileOutputStream output (csvFile);
+
+        if (! output.openedOk() || ! output.truncate().wasOk())
+            return false;
+
+        output.writeText ("time_us,sample_position,direction,parameter_index,bytes\n", false, false, nullptr);
+
+        for (const auto& event : events)
+        {
+            output.writeText (juce::String (event.wallClockMicros) + ","
+                                + juce::String (event.samplePosition) + ","
+                                + (event.direction == outgoing ? "out" : "in") + ","
+                                + juce::String (event.parameterIndex) + ","
+                                + juce::String::toHexString (event.bytes.data(), static_cast<int> (event.bytes.size())) + "\n",
+                              false, false, nullptr);
+        }
+
+        output.flush();
+        return ! output.getStatus().failed();
+    }
+
+    // Track 1 = outgoing, track 2 = incoming, SMPTE timing at 1 ms resolution
+    static bool convertToMidiFile (const juce::File& traceFile, const juce::File& midiFile)
+    {
+        std::vector<Event> events;
+        juce::int64 startTimeMillis = 0;
+        double sampleRate = 0.0;
+
+        if (! readTraceFile (traceFile, events, startTimeMillis, sampleRate))
+            return false;
+
+        juce::MidiMessageSequence tracks[2];
+
+        for (const auto& event : events)
+        {
+            // Realtime bytes (Active Sensing) carry no information in a file
+            if (event.bytes.empty() || event.bytes[0] >= 0xF8)
+                continue;
+
+            const double ticks = static_cast<double> (event.wallClockMicros) / 1000.0;
+            tracks[event.direction == outgoing ? 0 : 1].addEvent (
+                juce::MidiMessage (event.bytes.data(), static_cast<int> (event.bytes.size()), ticks));
+        }
+
+        juce::MidiFile midi;
+        midi.setSmpteTimeFormat (25, 40);
+
+        for (auto& track : tracks)
+        {
+            track.sort();
+            midi.addTrack (track);
+        }
+
+        juce::FileOutputStream output (midiFile);
+
+        if (! output.openedOk() || ! output.truncate().wasOk())
+            return false;
+
+        return midi.writeTo (output);
+    }
+
+private:
+    static constexpr int fileMagic = 0x4A503854;        // "JP8T"
+    static constexpr int fileVersion = 1;
+    static constexpr int payloadSize = 24;
+    static constexpr int maxMessageSize = 1024;
+    static constexpr uint64_t ringSize = 16384;         // ~1 MB, several seconds of dense traffic
+    static constexpr uint64_t indexMask = ringSize - 1;
+    static constexpr int flushIntervalMs = 100;
+
+    struct Record
+    {
+        std::atomic<uint64_t> sequence { 0 };           // Index + 1 once published
+        juce::int64 wallClockMicros = 0;
+        juce::int64 samplePosition = -1;
+        int16_t parameterIndex = -1;
+        Direction direction = outgoing;
+        uint16_t totalSize = 0;
+        uint16_t chunkIndex = 0;
+        std::array<uint8_t, payloadSize> payload {};
+    };
+
+    static juce::int64 ticksToMicros (juce::int64 ticks)
+    {
+        return static_cast<juce::int64> (juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6);
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            drain();
+            wait (flushIntervalMs);
+        }
+
+        drain();
+        stream->flush();
+        stream.reset();
+
+        // Post-mortem formats next to the binary trace
+        convertToCSV (file, file.withFileExtension ("csv"));
+        convertToMidiFile (file, file.withFileExtension ("mid"));
+    }
+
+    enum class ReadResult
+    {
+        ok,
+        notPublished,       // Writer hasn't finished yet, try again on the next flush
+        lost                // Overwritten by a writer that lapped the reader
+    };
+
+    ReadResult readRecord (uint64_t index, Record& destination)
+    {
+        auto& r = records[index & indexMask];
+        const auto sequence = r.sequence.load (std::memory_order_acquire);
+
+        if (sequence < index + 1)
+            return ReadResult::notPublished;
+
+        if (sequence > index + 1)
+            return ReadResult::lost;
+
+        destination.wallClockMicros = r.wallClockMicros;
+        destination.samplePosition = r.samplePosition;
+        destination.parameterIndex = r.parameterIndex;
+        destination.direction = r.direction;
+        destination.totalSize = r.totalSize;
+        destination.chunkIndex = r.chunkIndex;
+        destination.payload = r.payload;
+
+        // A writer may have reused the record while it was copied
+        std::atomic_thread_fence (std::memory_order_acquire);
+        return r.sequence.load (std::memory_order_relaxed) == sequence ? ReadResult::ok : ReadResult::lost;
+    }
+
+    // Jump ahead to half a ring behind the writers
+    void skipLostRecords()
+    {
+        const auto newReadIndex = writeIndex.load() - ringSize / 2;
+
+        if (newReadIndex > readIndex)
+        {
+            lostRecords += static_cast<juce::int64> (newReadIndex - readIndex);
+            readIndex = newReadIndex;
+        }
+        else
+        {
+            ++readIndex;
+            ++lostRecords;
+        }
+    }
+
+    void drain()
+    {
+        std::array<uint8_t, maxMessageSize> message;
+        Record header, r;
+
+        while (readIndex < writeIndex.load (std::memory_order_acquire))
+        {
+            auto result = readRecord (readIndex, header);
+
+            if (result == ReadResult::notPublished)
+                return;
+
+            // Continuation records without their first record are unusable
+            if (result == ReadResult::lost || header.chunkIndex != 0)
+            {
+                skipLostRecords();
+                continue;
+            }
+
+            const int size = header.totalSize;
+            const int numChunks = (size + payloadSize - 1) / payloadSize;
+
+            std::memcpy (message.data(), header.payload.data(), static_cast<size_t> (juce::jmin (payloadSize, size)));
+
+            for (int chunk = 1; chunk < numChunks && result == ReadResult::ok; ++chunk)
+            {
+                result = readRecord (readIndex + static_cast<uint64_t> (chunk), r);
+
+                const int offset = chunk * payloadSize;
+                std::memcpy (message.data() + offset, r.payload.data(), static_cast<size_t> (juce::jmin (payloadSize, size - offset)));
+            }
+
+            if (result == ReadResult::notPublished)
+                return;
+
+            if (result == ReadResult::lost)
+            {
+                skipLostRecords();
+                continue;
+            }
+
+            readIndex += static_cast<uint64_t> (numChunks);
+
+            stream->writeInt64 (header.wallClockMicros);
+            stream->writeInt64 (header.samplePosition);
+            stream->writeShort (header.parameterIndex);
+            stream->writeByte (static_cast<char> (header.direction));
+            stream->writeShort (static_cast<short> (size));
+            stream->write (message.data(), static_cast<size_t> (size));
+        }
+    }
+
+    //==============================================================================
+    std::array<Record, ringSize> records;
+    std::atomic<uint64_t> writeIndex { 0 };
+    uint64_t readIndex = 0;                             // Flush thread only
+    std::atomic<juce::int64> lostRecords { 0 };
+    std::atomic<juce::int64> startTicks { 0 };
+    std::atomic<bool> recording { false };
+
+    juce::File file;
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080TraceRecorder)
+};
@@ -1,6 +1,132 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+// Editor layout
+// Every parameter section is described here once: creation, layout and
+// painting all iterate these tables.
+namespace
+{
+    using namespace JP8080Parameters;
+
+    struct PanelDescriptor
+    {
+        const char* title;
+        int x, y, width, height;
+    };
+
+    struct KnobDescriptor
+    {
+        const juce::String& paramID;
+        const char* label;
+        int x, y;                       // Top left of the knob's column within its panel row
+    };
+
+    struct ChoiceDescriptor
+    {
+        const juce::String& paramID;
+        const char* label;
+        const juce::StringArray& items;
+        juce::Rectangle<int> labelBounds;
+        juce::Rectangle<int> comboBounds;
+    };
+
+    const PanelDescriptor panelDescriptors[] =
+    {
+        // Row 1: OSCILLATOR sections
+        { "OSCILLATOR 1",       10, 100, 190, 160 },
+        { "OSCILLATOR 2",      210, 100, 340, 160 },
+        { "OSC COMMON",        560, 100, 330, 160 },
+
+        // Row 2: FILTER and ENVELOPE sections
+        { "FILTER",             10, 280, 330, 140 },
+        { "FILTER ENVELOPE",   350, 280, 410, 140 },
+        { "AMP ENVELOPE",      770, 280, 420, 140 },
+
+        // Row 3: LFO, PITCH ENV, and EFFECTS sections
+        { "LFO 1",              10, 440, 180, 160 },
+        { "LFO 2",             200, 440, 180, 160 },
+        { "PITCH ENV",         390, 440, 240, 160 },
+        { "EFFECTS",           640, 440, 550, 160 }
+    };
+
+    const KnobDescriptor knobDescriptors[] =
+    {
+        // OSCILLATOR 1
+        { Oscillator::osc1Control1,   "Ctrl 1",           20, 100 },
+        { Oscillator::osc1Control2,   "Ctrl 2",          100, 100 },
+
+        // OSCILLATOR 2
+        { Oscillator::osc2Range,      "Range",           220, 100 },
+        { Oscillator::osc2FineWide,   "Fine",            300, 100 },
+        { Oscillator::osc2Control1,   "Ctrl 1",          380, 100 },
+        { Oscillator::osc2Control2,   "Ctrl 2",          460, 100 },
+
+        // OSC COMMON
+        { Oscillator::oscBalance,     "Balance",         570, 100 },
+        { Oscillator::xModDepth,      "X-Mod",           650, 100 },
+        { Oscillator::oscLfo1Depth,   "LFO Depth",       730, 100 },
+
+        // FILTER
+        { Filter::cutoff,             "Cutoff",           20, 280 },
+        { Filter::resonance,          "Resonance",       100, 280 },
+        { Filter::keyFollow,          "Key Follow",      180, 280 },
+        { Filter::lfo1Depth,          "LFO Depth",       260, 280 },
+
+        // FILTER ENVELOPE
+        { Filter::envDepth,           "Depth",           360, 280 },
+        { Filter::envAttack,          "Attack",          440, 280 },
+        { Filter::envDecay,           "Decay",           520, 280 },
+        { Filter::envSustain,         "Sustain",         600, 280 },
+        { Filter::envRelease,         "Release",         680, 280 },
+
+        // AMP ENVELOPE
+        { Amplifier::level,           "Level",           780, 280 },
+        { Amplifier::envAttack,       "Attack",          860, 280 },
+        { Amplifier::envDecay,        "Decay",           940, 280 },
+        { Amplifier::envSustain,      "Sustain",        1020, 280 },
+        { Amplifier::envRelease,      "Release",        1100, 280 },
+
+        // LFO 1 / LFO 2
+        { LFO::lfo1Rate,              "Rate",             20, 440 },
+        { LFO::lfo1Fade,              "Fade",            100, 440 },
+        { LFO::lfo2Rate,              "Rate",            210, 440 },
+        { LFO::lfo2PitchDepth,        "Depth",           290, 440 },
+
+        // PITCH ENV
+        { PitchEnv::depth,            "Depth",           400, 440 },
+        { PitchEnv::attack,           "Attack",          480, 440 },
+        { PitchEnv::decay,            "Decay",           560, 440 },
+
+        // EFFECTS
+        { Effects::toneCtrlBass,      "Bass",            650, 440 },
+        { Effects::toneCtrlTreble,    "Treble",          730, 440 },
+        { Effects::multiFxLevel,      "FX Level",        810, 440 },
+        { Effects::delayTime,         "Delay Time",      890, 440 },
+        { Effects::delayFeedback,     "Delay Feedback",  970, 440 },
+        { Effects::delayLevel,        "Delay Level",    1050, 440 }
+    };
+
+    const ChoiceDescriptor choiceDescriptors[] =
+    {
+        { Oscillator::osc1Waveform,   "Waveform:",  osc1WaveformNames,  {  20, 228, 70, 20 }, {  95, 228,  90, 20 } },
+        { Oscillator::osc2Waveform,   "Waveform:",  osc2WaveformNames,  { 220, 228, 70, 20 }, { 295, 228,  90, 20 } },
+        { LFO::lfo1Waveform,          "Waveform:",  lfo1WaveformNames,  {  20, 568, 70, 20 }, {  95, 568,  80, 20 } },
+        { Effects::multiFxType,       "Multi-FX:",  multiFxTypeNames,   { 650, 568, 70, 20 }, { 725, 568, 165, 20 } },
+        { Effects::delayType,         "Delay:",     delayTypeNames,     { 890, 568, 50, 20 }, { 945, 568, 155, 20 } }
+    };
+
+    constexpr int numKnobs = static_cast<int> (std::size (knobDescriptors));
+    constexpr int numChoices = static_cast<int> (std::size (choiceDescriptors));
+
+    // Knob placement relative to its descriptor position
+    juce::Rectangle<int> getKnobBounds (const KnobDescriptor& knob)        { return { knob.x, knob.y + 30, 70, 70 }; }
+    juce::Rectangle<int> getKnobLabelBounds (const KnobDescriptor& knob)   { return { knob.x, knob.y + 105, 70, 16 }; }
+
+    // Same text area as a juce::Label with its default border
+    juce::Rectangle<int> getLabelTextArea (juce::Rectangle<int> labelBounds)  { return labelBounds.reduced (5, 1); }
+}
+
 //==============================================================================
 JP8080ControllerAudioProcessorEditor::JP8080ControllerAudioProcessorEditor (JP8080ControllerAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
@@ -10,6 +136,9 @@ JP8080ControllerAudioProcessorEditor::JP8080ControllerAudioProcessorEditor (JP80
     // Set larger window size for full control layout (wider for single-row panels)
     setSize (1200, 610);
 
+    // The cached background covers the whole editor
+    setOpaque (true);
+
     // Apply custom LookAndFeel
     setLookAndFeel(&jp8080LookAndFeel);
 
@@ -22,8 +151,79 @@ JP8080ControllerAudioProcessorEditor::JP8080ControllerAudioProcessorEditor (JP80
 
     midiOutputCombo.addListener (this);
     addAndMakeVisible (midiOutputCombo);
+    deviceListGeneration = audioProcessor.getDeviceListGeneration();
     populateMidiOutputList();
 
+    // MIDI Input Device Selector (receives patch data from the JP-8080)
+    midiInputLabel.setText ("MIDI Input:", juce::dontSendNotification);
+    midiInputLabel.setJustificationType (juce::Justification::centredRight);
+    addAndMakeVisible (midiInputLabel);
+
+    midiInputCombo.addListener (this);
+    addAndMakeVisible (midiInputCombo);
+    populateMidiInputList();
+
+    readPatchesButton.addListener (this);
+    addAndMakeVisible (readPatchesButton);
+
+    // Backup / Restore
+    backupButton.addListener (this);
+    addAndMakeVisible (backupButton);
+    restoreButton.addListener (this);
+    addAndMakeVisible (restoreButton);
+    cancelTransferButton.addListener (this);
+    addChildComponent (cancelTransferButton);
+    addChildComponent (transferProgressBar);
+    updateTransferControls();
+
+    // Traffic trace
+    traceButton.setClickingTogglesState (true);
+    traceButton.setToggleState (audioProcessor.isTraceRecording(), juce::dontSendNotification);
+    traceButton.addListener (this);
+    addAndMakeVisible (traceButton);
+
+    // Undo / redo and A/B compare
+    for (auto* button : { &undoButton, &redoButton, &compareButton, &copySlotButton })
+    {
+        button->addListener (this);
+        addAndMakeVisible (button);
+    }
+
+    updateHistoryControls();
+
+    // Scenes
+    sceneCombo.addItemList (offOneToSixteenNames, 1);
+    sceneCombo.addListener (this);
+    addAndMakeVisible (sceneCombo);
+    sceneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getValueTreeState(), Scene::select, sceneCombo);
+
+    for (auto* button : { &storeSceneButton, &clearSceneButton })
+    {
+        button->addListener (this);
+        addAndMakeVisible (button);
+    }
+
+    updateSceneControls();
+
+    // Diagnostics overlay (hidden until toggled)
+    diagnosticsButton.setClickingTogglesState (true);
+    diagnosticsButton.addListener (this);
+    addAndMakeVisible (diagnosticsButton);
+    addChildComponent (diagnosticsOverlay);
+
+    // Connection status
+    connectionStatusLabel.setJustificationType (juce::Justification::centredLeft);
+    connectionStatusLabel.setFont (juce::Font (12.0f));
+    addAndMakeVisible (connectionStatusLabel);
+    updateConnectionStatus();
+
+    pauseWhenDisconnectedButton.setToggleState (audioProcessor.getPauseOutputWhenDisconnected(), juce::dontSendNotification);
+    pauseWhenDisconnectedButton.addListener (this);
+    addAndMakeVisible (pauseWhenDisconnectedButton);
+
+    startTimerHz (idleRefreshHz);
+
     partLabel.setText ("Part:", juce::dontSendNotification);
     partLabel.setJustificationType (juce::Justification::centredRight);
     addAndMakeVisible (partLabel);
@@ -56,109 +256,55 @@ JP8080ControllerAudioProcessorEditor::JP8080ControllerAudioProcessorEditor (JP80
     // Update patch names for currently selected bank
     updatePatchNamesForCurrentBank();
 
-    // Oscillator Section
-    osc1WaveformLabel.setText("Waveform:", juce::dontSendNotification);
-    osc1WaveformLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(osc1WaveformLabel);
-    osc1WaveformCombo.addItemList(osc1WaveformNames, 1);
-    addAndMakeVisible(osc1WaveformCombo);
-    osc1WaveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getValueTreeState(), Oscillator::osc1Waveform, osc1WaveformCombo);
-
-    createRotaryKnob(osc1Control1Knob, osc1Control1Label, Oscillator::osc1Control1, "Ctrl 1");
-    createRotaryKnob(osc1Control2Knob, osc1Control2Label, Oscillator::osc1Control2, "Ctrl 2");
-
-    osc2WaveformLabel.setText("Waveform:", juce::dontSendNotification);
-    osc2WaveformLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(osc2WaveformLabel);
-    osc2WaveformCombo.addItemList(osc2WaveformNames, 1);
-    addAndMakeVisible(osc2WaveformCombo);
-    osc2WaveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getValueTreeState(), Oscillator::osc2Waveform, osc2WaveformCombo);
-
-    createRotaryKnob(osc2RangeKnob, osc2RangeLabel, Oscillator::osc2Range, "Range");
-    createRotaryKnob(osc2FineKnob, osc2FineLabel, Oscillator::osc2FineWide, "Fine");
-    createRotaryKnob(osc2Control1Knob, osc2Control1Label, Oscillator::osc2Control1, "Ctrl 1");
-    createRotaryKnob(osc2Control2Knob, osc2Control2Label, Oscillator::osc2Control2, "Ctrl 2");
-    createRotaryKnob(oscBalanceKnob, oscBalanceLabel, Oscillator::oscBalance, "Balance");
-    createRotaryKnob(xModDepthKnob, xModDepthLabel, Oscillator::xModDepth, "X-Mod");
-    createRotaryKnob(oscLfo1DepthKnob, oscLfo1DepthLabel, Oscillator::oscLfo1Depth, "LFO Depth");
-
-    // Filter Section
-    createRotaryKnob(filterCutoffKnob, filterCutoffLabel, Filter::cutoff, "Cutoff");
-    createRotaryKnob(filterResonanceKnob, filterResonanceLabel, Filter::resonance, "Resonance");
-    createRotaryKnob(filterKeyFollowKnob, filterKeyFollowLabel, Filter::keyFollow, "Key Follow");
-    createRotaryKnob(filterLfo1DepthKnob, filterLfo1DepthLabel, Filter::lfo1Depth, "LFO Depth");
-    createRotaryKnob(filterEnvDepthKnob, filterEnvDepthLabel, Filter::envDepth, "Depth");
-
-    // Filter Envelope
-    createRotaryKnob(filterAttackKnob, filterAttackLabel, Filter::envAttack, "Attack");
-    createRotaryKnob(filterDecayKnob, filterDecayLabel, Filter::envDecay, "Decay");
-    createRotaryKnob(filterSustainKnob, filterSustainLabel, Filter::envSustain, "Sustain");
-    createRotaryKnob(filterReleaseKnob, filterReleaseLabel, Filter::envRelease, "Release");
-
-    // Amplifier Section
-    createRotaryKnob(ampLevelKnob, ampLevelLabel, Amplifier::level, "Level");
-    createRotaryKnob(ampAttackKnob, ampAttackLabel, Amplifier::envAttack, "Attack");
-    createRotaryKnob(ampDecayKnob, ampDecayLabel, Amplifier::envDecay, "Decay");
-    createRotaryKnob(ampSustainKnob, ampSustainLabel, Amplifier::envSustain, "Sustain");
-    createRotaryKnob(ampReleaseKnob, ampReleaseLabel, Amplifier::envRelease, "Release");
-
-    // LFO Section
-    lfo1WaveformLabel.setText("Waveform:", juce::dontSendNotification);
-    lfo1WaveformLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(lfo1WaveformLabel);
-    lfo1WaveformCombo.addItemList(lfo1WaveformNames, 1);
-    addAndMakeVisible(lfo1WaveformCombo);
-    lfo1WaveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getValueTreeState(), LFO::lfo1Waveform, lfo1WaveformCombo);
-
-    createRotaryKnob(lfo1RateKnob, lfo1RateLabel, LFO::lfo1Rate, "Rate");
-    createRotaryKnob(lfo1FadeKnob, lfo1FadeLabel, LFO::lfo1Fade, "Fade");
-    createRotaryKnob(lfo2RateKnob, lfo2RateLabel, LFO::lfo2Rate, "Rate");
-    createRotaryKnob(lfo2DepthKnob, lfo2DepthLabel, LFO::lfo2PitchDepth, "Depth");
-
-    // Pitch Envelope Section
-    createRotaryKnob(pitchEnvDepthKnob, pitchEnvDepthLabel, PitchEnv::depth, "Depth");
-    createRotaryKnob(pitchEnvAttackKnob, pitchEnvAttackLabel, PitchEnv::attack, "Attack");
-    createRotaryKnob(pitchEnvDecayKnob, pitchEnvDecayLabel, PitchEnv::decay, "Decay");
-
-    // Effects Section
-    createRotaryKnob(toneCtrlBassKnob, toneCtrlBassLabel, Effects::toneCtrlBass, "Bass");
-    createRotaryKnob(toneCtrlTrebleKnob, toneCtrlTrebleLabel, Effects::toneCtrlTreble, "Treble");
-
-    multiFxTypeLabel.setText("Multi-FX:", juce::dontSendNotification);
-    multiFxTypeLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(multiFxTypeLabel);
-    multiFxTypeCombo.addItemList(multiFxTypeNames, 1);
-    addAndMakeVisible(multiFxTypeCombo);
-    multiFxTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getValueTreeState(), Effects::multiFxType, multiFxTypeCombo);
-
-    createRotaryKnob(multiFxLevelKnob, multiFxLevelLabel, Effects::multiFxLevel, "FX Level");
-
-    delayTypeLabel.setText("Delay:", juce::dontSendNotification);
-    delayTypeLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(delayTypeLabel);
-    delayTypeCombo.addItemList(delayTypeNames, 1);
-    addAndMakeVisible(delayTypeCombo);
-    delayTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.getValueTreeState(), Effects::delayType, delayTypeCombo);
-
-    createRotaryKnob(delayTimeKnob, delayTimeLabel, Effects::delayTime, "Delay Time");
-    createRotaryKnob(delayFeedbackKnob, delayFeedbackLabel, Effects::delayFeedback, "Delay Feedback");
-    createRotaryKnob(delayLevelKnob, delayLevelLabel, Effects::delayLevel, "Delay Level");
+    // Parameter sections
+    createSections();
 }
 
 JP8080ControllerAudioProcessorEditor::~JP8080ControllerAudioProcessorEditor()
 {
     midiOutputCombo.removeListener(this);
+    midiInputCombo.removeListener(this);
+    readPatchesButton.removeListener(this);
+    backupButton.removeListener(this);
+    restoreButton.removeListener(this);
+    cancelTransferButton.removeListener(this);
+    diagnosticsButton.removeListener(this);
+    traceButton.removeListener(this);
+    pauseWhenDisconnectedButton.removeListener(this);
+    undoButton.removeListener(this);
+    redoButton.removeListener(this);
+    compareButton.removeListener(this);
+    copySlotButton.removeListener(this);
+    storeSceneButton.removeListener(this);
+    clearSceneButton.removeListener(this);
+    sceneCombo.removeListener(this);
     patchBankCombo.removeListener(this);
     setLookAndFeel(nullptr);
 }
 
 //==============================================================================
 void JP8080ControllerAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    // Static artwork is rendered once per scale factor; knob repaints only blit the part they cover
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! backgroundImage.isValid() || scale != backgroundScale)
+    {
+        backgroundScale = scale;
+        backgroundImage = juce::Image (juce::Image::RGB,
+                                       juce::jmax (1, juce::roundToInt (getWidth() * scale)),
+                                       juce::jmax (1, juce::roundToInt (getHeight() * scale)),
+                                       false);
+
+        juce::Graphics imageGraphics (backgroundImage);
+        imageGraphics.addTransform (juce::AffineTransform::scale (scale));
+        paintBackground (imageGraphics);
+    }
+
+    g.drawImage (backgroundImage, getLocalBounds().toFloat());
+}
+
+void JP8080ControllerAudioProcessorEditor::paintBackground (juce::Graphics& g)
 {
     // Background
     g.fillAll (juce::Colour (0xff1a1a1a));
@@ -197,27 +343,44 @@ void JP8080ControllerAudioProcessorEditor::paint (juce::Graphics& g)
         g.fillRect (x + 10, y + 25, w - 20, 1);
     };
 
-    // Row 1: OSCILLATOR sections
-    drawPanel (10, 100, 190, 160, "OSCILLATOR 1");
-    drawPanel (210, 100, 340, 160, "OSCILLATOR 2");
-    drawPanel (560, 100, 330, 160, "OSC COMMON");
-
-    // Row 2: FILTER and ENVELOPE sections (single row layout)
-    drawPanel (10, 280, 330, 140, "FILTER");
-    drawPanel (350, 280, 410, 140, "FILTER ENVELOPE");
-    drawPanel (770, 280, 420, 140, "AMP ENVELOPE");
-
-    // Row 3: LFO, PITCH ENV, and EFFECTS sections (single row layout)
-    drawPanel (10, 440, 180, 160, "LFO 1");
-    drawPanel (200, 440, 180, 160, "LFO 2");
-    drawPanel (390, 440, 240, 160, "PITCH ENV");
-    drawPanel (640, 440, 550, 160, "EFFECTS");
+    for (const auto& panel : panelDescriptors)
+        drawPanel (panel.x, panel.y, panel.width, panel.height, panel.title);
+
+    // Control labels
+    g.setColour (findColour (juce::Label::textColourId));
+
+    g.setFont (juce::Font (11.0f));
+    for (const auto& knob : knobDescriptors)
+        g.drawFittedText (knob.label, getLabelTextArea (getKnobLabelBounds (knob)), juce::Justification::centred, 1);
+
+    g.setFont (juce::Font (15.0f));
+    for (const auto& choice : choiceDescriptors)
+        g.drawFittedText (choice.label, getLabelTextArea (choice.labelBounds), juce::Justification::centredRight, 1);
 }
 
 void JP8080ControllerAudioProcessorEditor::resized()
 {
+    // Re-rendered at the new size on the next paint
+    backgroundImage = {};
+
     auto bounds = getLocalBounds();
 
+    // Trace and diagnostics toggles next to the title, overlay in the free space right of OSC COMMON
+    traceButton.setBounds (165, 14, 75, 20);
+    diagnosticsButton.setBounds (165, 44, 75, 20);
+    diagnosticsOverlay.setBounds (895, 100, 295, 160);
+
+    // Output hold option, scenes, then history and compare along the bottom of that free space
+    pauseWhenDisconnectedButton.setBounds (900, 184, 280, 20);
+    sceneCombo.setBounds (900, 210, 135, 20);
+    storeSceneButton.setBounds (1050, 210, 60, 20);
+    clearSceneButton.setBounds (1115, 210, 65, 20);
+    undoButton.setBounds (900, 236, 65, 20);
+    redoButton.setBounds (970, 236, 65, 20);
+    compareButton.setBounds (1050, 236, 60, 20);
+    copySlotButton.setBounds (1115, 236, 65, 20);
+    diagnosticsOverlay.toFront (false);
+
     // Header area for MIDI config
     auto headerArea = bounds.removeFromTop (70);
     headerArea.removeFromLeft (250); // Skip title area
@@ -227,7 +390,15 @@ void JP8080ControllerAudioProcessorEditor::resized()
     auto midiOutputRow = headerArea.removeFromTop (20);
     midiOutputLabel.setBounds (midiOutputRow.removeFromLeft (85));
     midiOutputRow.removeFromLeft (5);
-    midiOutputCombo.setBounds (midiOutputRow.removeFromLeft (250));
+    midiOutputCombo.setBounds (midiOutputRow.removeFromLeft (230));
+    midiOutputRow.removeFromLeft (15);
+    midiInputLabel.setBounds (midiOutputRow.removeFromLeft (75));
+    midiOutputRow.removeFromLeft (5);
+    midiInputCombo.setBounds (midiOutputRow.removeFromLeft (230));
+    midiOutputRow.removeFromLeft (15);
+    readPatchesButton.setBounds (midiOutputRow.removeFromLeft (100));
+    midiOutputRow.removeFromLeft (10);
+    connectionStatusLabel.setBounds (midiOutputRow.removeFromLeft (140));
 
     headerArea.removeFromTop (5); // Spacing between rows
 
@@ -244,214 +415,74 @@ void JP8080ControllerAudioProcessorEditor::resized()
     patchNameLabel.setBounds (midiRow.removeFromLeft (80));
     midiRow.removeFromLeft (5);
     patchNameCombo.setBounds (midiRow.removeFromLeft (180));
+    midiRow.removeFromLeft (15);
+    backupButton.setBounds (midiRow.removeFromLeft (70));
+    midiRow.removeFromLeft (5);
+    restoreButton.setBounds (midiRow.removeFromLeft (70));
+    midiRow.removeFromLeft (5);
+    cancelTransferButton.setBounds (midiRow.removeFromLeft (55));
+    midiRow.removeFromLeft (5);
+    transferProgressBar.setBounds (midiRow.removeFromLeft (120));
 
-    // Helper lambda to position a knob
-    auto positionKnob = [](juce::Slider& knob, juce::Label& label, int x, int y)
-    {
-        knob.setBounds (x, y + 30, 70, 70);
-        label.setBounds (x, y + 105, 70, 16);
-    };
+    // Parameter sections
+    for (int i = 0; i < numKnobs; ++i)
+        knobs[i].setBounds (getKnobBounds (knobDescriptors[i]));
 
-    // Row 1: Oscillator sections
-    // OSCILLATOR 1 knobs and waveform selector
-    positionKnob (osc1Control1Knob, osc1Control1Label, 20, 100);
-    positionKnob (osc1Control2Knob, osc1Control2Label, 100, 100);
-    osc1WaveformLabel.setBounds (20, 228, 70, 20);
-    osc1WaveformCombo.setBounds (95, 228, 90, 20);
-
-    // OSCILLATOR 2 knobs and waveform selector
-    positionKnob (osc2RangeKnob, osc2RangeLabel, 220, 100);
-    positionKnob (osc2FineKnob, osc2FineLabel, 300, 100);
-    positionKnob (osc2Control1Knob, osc2Control1Label, 380, 100);
-    positionKnob (osc2Control2Knob, osc2Control2Label, 460, 100);
-    osc2WaveformLabel.setBounds (220, 228, 70, 20);
-    osc2WaveformCombo.setBounds (295, 228, 90, 20);
-
-    // OSC COMMON (3 knobs)
-    positionKnob (oscBalanceKnob, oscBalanceLabel, 570, 100);
-    positionKnob (xModDepthKnob, xModDepthLabel, 650, 100);
-    positionKnob (oscLfo1DepthKnob, oscLfo1DepthLabel, 730, 100);
-
-    // Row 2: Filter and Envelope sections (single row)
-    // FILTER (4 knobs in one row)
-    positionKnob (filterCutoffKnob, filterCutoffLabel, 20, 280);
-    positionKnob (filterResonanceKnob, filterResonanceLabel, 100, 280);
-    positionKnob (filterKeyFollowKnob, filterKeyFollowLabel, 180, 280);
-    positionKnob (filterLfo1DepthKnob, filterLfo1DepthLabel, 260, 280);
-
-    // FILTER ENVELOPE (5 knobs in one row)
-    positionKnob (filterEnvDepthKnob, filterEnvDepthLabel, 360, 280);
-    positionKnob (filterAttackKnob, filterAttackLabel, 440, 280);
-    positionKnob (filterDecayKnob, filterDecayLabel, 520, 280);
-    positionKnob (filterSustainKnob, filterSustainLabel, 600, 280);
-    positionKnob (filterReleaseKnob, filterReleaseLabel, 680, 280);
-
-    // AMP ENVELOPE (5 knobs in one row)
-    positionKnob (ampLevelKnob, ampLevelLabel, 780, 280);
-    positionKnob (ampAttackKnob, ampAttackLabel, 860, 280);
-    positionKnob (ampDecayKnob, ampDecayLabel, 940, 280);
-    positionKnob (ampSustainKnob, ampSustainLabel, 1020, 280);
-    positionKnob (ampReleaseKnob, ampReleaseLabel, 1100, 280);
-
-    // Row 3: LFO, Pitch Env, and Effects sections (single row)
-    // LFO 1 knobs and waveform selector
-    positionKnob (lfo1RateKnob, lfo1RateLabel, 20, 440);
-    positionKnob (lfo1FadeKnob, lfo1FadeLabel, 100, 440);
-    lfo1WaveformLabel.setBounds (20, 568, 70, 20);
-    lfo1WaveformCombo.setBounds (95, 568, 80, 20);
-
-    // LFO 2 (2 knobs in one row)
-    positionKnob (lfo2RateKnob, lfo2RateLabel, 210, 440);
-    positionKnob (lfo2DepthKnob, lfo2DepthLabel, 290, 440);
-
-    // PITCH ENV (3 knobs in one row)
-    positionKnob (pitchEnvDepthKnob, pitchEnvDepthLabel, 400, 440);
-    positionKnob (pitchEnvAttackKnob, pitchEnvAttackLabel, 480, 440);
-    positionKnob (pitchEnvDecayKnob, pitchEnvDecayLabel, 560, 440);
-
-    // EFFECTS (6 knobs in one row + 2 type selectors)
-    positionKnob (toneCtrlBassKnob, toneCtrlBassLabel, 650, 440);
-    positionKnob (toneCtrlTrebleKnob, toneCtrlTrebleLabel, 730, 440);
-    multiFxTypeLabel.setBounds (650, 568, 70, 20);
-    multiFxTypeCombo.setBounds (725, 568, 165, 20);
-    positionKnob (multiFxLevelKnob, multiFxLevelLabel, 810, 440);
-    delayTypeLabel.setBounds (890, 568, 50, 20);
-    delayTypeCombo.setBounds (945, 568, 155, 20);
-    positionKnob (delayTimeKnob, delayTimeLabel, 890, 440);
-    positionKnob (delayFeedbackKnob, delayFeedbackLabel, 970, 440);
-    positionKnob (delayLevelKnob, delayLevelLabel, 1050, 440);
+    for (int i = 0; i < numChoices; ++i)
+        choiceCombos[i].setBounds (choiceDescriptors[i].comboBounds);
 }
 
 //==============================================================================
-void JP8080ControllerAudioProcessorEditor::createRotaryKnob(juce::Slider& slider, juce::Label& label,
-                                                              const juce::String& paramID, const juce::String& labelText)
+void JP8080ControllerAudioProcessorEditor::createSections()
+{
+    auto& apvts = audioProcessor.getValueTreeState();
+
+    knobs = std::make_unique<juce::Slider[]> (static_cast<size_t> (numKnobs));
+    knobAttachments.reserve (static_cast<size_t> (numKnobs));
+
+    for (int i = 0; i < numKnobs; ++i)
+        createRotaryKnob (knobs[i], knobDescriptors[i].paramID);
+
+    choiceCombos = std::make_unique<juce::ComboBox[]> (static_cast<size_t> (numChoices));
+    choiceAttachments.reserve (static_cast<size_t> (numChoices));
+
+    for (int i = 0; i < numChoices; ++i)
+    {
+        const auto& choice = choiceDescriptors[i];
+        auto& combo = choiceCombos[i];
+
+        combo.addItemList (choice.items, 1);
+        addAndMakeVisible (combo);
+        choiceAttachments.push_back (std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+            apvts, choice.paramID, combo));
+    }
+}
+
+void JP8080ControllerAudioProcessorEditor::createRotaryKnob(juce::Slider& slider, const juce::String& paramID)
 {
     // Configure slider as rotary knob
     slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     slider.setTextBoxStyle (juce::Slider::NoTextBox, false, 0, 0);
-    slider.setRange (0, 127, 1);
     slider.setLookAndFeel (&jp8080LookAndFeel);
     addAndMakeVisible (slider);
 
-    // Create APVTS attachment
+    // Found again by mouseDown() for the MIDI learn menu
+    slider.getProperties().set ("paramID", paramID);
+    slider.addMouseListener (this, false);
+
+    // Create parameter attachment, refreshed from timerCallback()
     auto* param = audioProcessor.getValueTreeState().getParameter(paramID);
-    if (param != nullptr)
-    {
-        if (paramID == JP8080Parameters::Oscillator::osc1Control1)
-            osc1Control1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::osc1Control2)
-            osc1Control2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::osc2Range)
-            osc2RangeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::osc2FineWide)
-            osc2FineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::oscBalance)
-            oscBalanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::xModDepth)
-            xModDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::osc2Control1)
-            osc2Control1Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::osc2Control2)
-            osc2Control2Attachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Oscillator::oscLfo1Depth)
-            oscLfo1DepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::cutoff)
-            filterCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::resonance)
-            filterResonanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::keyFollow)
-            filterKeyFollowAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::lfo1Depth)
-            filterLfo1DepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::envDepth)
-            filterEnvDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::envAttack)
-            filterAttackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::envDecay)
-            filterDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::envSustain)
-            filterSustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Filter::envRelease)
-            filterReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Amplifier::level)
-            ampLevelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Amplifier::envAttack)
-            ampAttackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Amplifier::envDecay)
-            ampDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Amplifier::envSustain)
-            ampSustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Amplifier::envRelease)
-            ampReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::LFO::lfo1Rate)
-            lfo1RateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::LFO::lfo1Fade)
-            lfo1FadeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::LFO::lfo2Rate)
-            lfo2RateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::LFO::lfo2PitchDepth)
-            lfo2DepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::PitchEnv::depth)
-            pitchEnvDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::PitchEnv::attack)
-            pitchEnvAttackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::PitchEnv::decay)
-            pitchEnvDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::toneCtrlBass)
-            toneCtrlBassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::toneCtrlTreble)
-            toneCtrlTrebleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::multiFxLevel)
-            multiFxLevelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::delayTime)
-            delayTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::delayFeedback)
-            delayFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-        else if (paramID == JP8080Parameters::Effects::delayLevel)
-            delayLevelAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-                audioProcessor.getValueTreeState(), paramID, slider);
-    }
+    if (param == nullptr)
+        return;
+
+    // Continuous parameters follow the mouse smoothly, switches snap
+    slider.setRange (0, 127, dynamic_cast<juce::AudioParameterFloat*>(param) != nullptr ? 0.0 : 1.0);
 
-    // Configure label
-    label.setText (labelText, juce::dontSendNotification);
-    label.setJustificationType (juce::Justification::centred);
-    label.setFont (juce::Font (11.0f));
-    addAndMakeVisible (label);
+    knobAttachments.push_back (std::make_unique<JP8080KnobAttachment>(*param, slider));
+
+    int knobIndex = audioProcessor.getKnobParameterIndex(paramID);
+    if (juce::isPositiveAndBelow(knobIndex, maxKnobParameters))
+        knobAttachmentsByIndex[static_cast<size_t>(knobIndex)] = knobAttachments.back().get();
 }
 
 //==============================================================================
@@ -468,7 +499,8 @@ void JP8080ControllerAudioProcessorEditor::populateMidiOutputList()
     int itemId = 2;
     for (const auto& device : midiOutputs)
     {
-        midiOutputCombo.addItem(device.name, itemId);
+        // Mark ports where discovery found a JP-8080
+        midiOutputCombo.addItem(audioProcessor.isJP8080Port(device.identifier) ? device.name + " [JP-8080]" : device.name, itemId);
         itemId++;
     }
 
@@ -494,12 +526,337 @@ void JP8080ControllerAudioProcessorEditor::populateMidiOutputList()
     }
 }
 
+void JP8080ControllerAudioProcessorEditor::populateMidiInputList()
+{
+    midiInputCombo.clear(juce::dontSendNotification);
+
+    // Add "None" option
+    midiInputCombo.addItem("-- Select MIDI Input --", 1);
+
+    // Get available MIDI inputs
+    auto midiInputs = audioProcessor.getAvailableMidiInputs();
+
+    int itemId = 2;
+    for (const auto& device : midiInputs)
+    {
+        midiInputCombo.addItem(audioProcessor.isJP8080Port(device.identifier) ? device.name + " [JP-8080]" : device.name, itemId);
+        itemId++;
+    }
+
+    // Select currently selected device
+    juce::String currentId = audioProcessor.getSelectedMidiInputId();
+    midiInputCombo.setSelectedId(1, juce::dontSendNotification); // "None" selected
+
+    int index = 2;
+    for (const auto& device : midiInputs)
+    {
+        if (device.identifier == currentId)
+        {
+            midiInputCombo.setSelectedId(index, juce::dontSendNotification);
+            break;
+        }
+        index++;
+    }
+}
+
+void JP8080ControllerAudioProcessorEditor::buttonClicked(juce::Button* button)
+{
+    if (button == &readPatchesButton)
+    {
+        audioProcessor.requestPatchCacheFill();
+    }
+    else if (button == &backupButton || button == &restoreButton)
+    {
+        const bool isBackup = (button == &backupButton);
+        auto defaultFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("JP-8080 Backup.syx");
+
+        fileChooser = std::make_unique<juce::FileChooser>(isBackup ? "Save JP-8080 Backup" : "Restore JP-8080 Backup",
+                                                          defaultFile, "*.syx");
+
+        auto flags = juce::FileBrowserComponent::canSelectFiles
+                   | (isBackup ? juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::warnAboutOverwriting
+                               : juce::FileBrowserComponent::openMode);
+
+        fileChooser->launchAsync(flags, [this, isBackup](const juce::FileChooser& chooser)
+        {
+            auto file = chooser.getResult();
+            if (file == juce::File())
+                return;
+
+            if (isBackup)
+                audioProcessor.startBackup(file.withFileExtension("syx"));
+            else
+                audioProcessor.startRestore(file);
+
+            updateTransferControls();
+        });
+    }
+    else if (button == &cancelTransferButton)
+    {
+        audioProcessor.getBulkTransfer().cancel();
+    }
+    else if (button == &undoButton || button == &redoButton
+             || button == &compareButton || button == &copySlotButton)
+    {
+        auto& history = audioProcessor.getSnapshotHistory();
+
+        if (button == &undoButton)
+            history.undo();
+        else if (button == &redoButton)
+            history.redo();
+        else if (button == &compareButton)
+            history.switchSlot();
+        else
+            history.copyToOtherSlot();
+
+        updateHistoryControls();
+    }
+    else if (button == &storeSceneButton || button == &clearSceneButton)
+    {
+        auto& scenes = audioProcessor.getSceneBank();
+        const int sceneIndex = sceneCombo.getSelectedItemIndex() - 1;
+
+        if (button == &storeSceneButton)
+            scenes.storeScene(sceneIndex);
+        else
+            scenes.clearScene(sceneIndex);
+
+        updateSceneControls();
+    }
+    else if (button == &diagnosticsButton)
+    {
+        diagnosticsOverlay.setVisible(diagnosticsButton.getToggleState());
+    }
+    else if (button == &traceButton)
+    {
+        if (!traceButton.getToggleState())
+            audioProcessor.stopTraceRecording();
+        else if (!audioProcessor.startTraceRecording())
+            traceButton.setToggleState(false, juce::dontSendNotification);
+    }
+    else if (button == &pauseWhenDisconnectedButton)
+    {
+        audioProcessor.setPauseOutputWhenDisconnected(pauseWhenDisconnectedButton.getToggleState());
+    }
+}
+
+void JP8080ControllerAudioProcessorEditor::timerCallback()
+{
+    const bool knobsChanged = updateKnobsFromParameters();
+    updateRefreshRate(knobsChanged);
+
+    const auto now = juce::Time::getMillisecondCounter();
+    if (now - lastStatusPollTime < statusPollIntervalMs)
+        return;
+
+    lastStatusPollTime = now;
+    updateTransferControls();
+    updateConnectionStatus();
+    updateHistoryControls();
+    updateSceneControls();
+
+    if (diagnosticsOverlay.isVisible())
+        diagnosticsOverlay.repaint();
+
+    // Ports appeared, disappeared or a JP-8080 was found
+    int generation = audioProcessor.getDeviceListGeneration();
+    if (generation != deviceListGeneration)
+    {
+        deviceListGeneration = generation;
+        populateMidiOutputList();
+        populateMidiInputList();
+    }
+}
+
+bool JP8080ControllerAudioProcessorEditor::updateKnobsFromParameters()
+{
+    auto dirty = audioProcessor.takeDirtyKnobParameters();
+    if (dirty == 0)
+        return false;
+
+    // All knob repaints of this frame are coalesced into a single paint pass
+    for (int index = 0; index < maxKnobParameters && dirty != 0; ++index, dirty >>= 1)
+    {
+        if ((dirty & 1) != 0 && knobAttachmentsByIndex[static_cast<size_t>(index)] != nullptr)
+            knobAttachmentsByIndex[static_cast<size_t>(index)]->updateFromParameter();
+    }
+
+    return true;
+}
+
+void JP8080ControllerAudioProcessorEditor::updateRefreshRate(bool knobsChanged)
+{
+    const auto now = juce::Time::getMillisecondCounter();
+
+    if (knobsChanged)
+        lastKnobChangeTime = now;
+
+    // Slow down while nobody can see the knobs
+    auto* peer = getPeer();
+    int refreshHz = idleRefreshHz;
+
+    if (!isShowing() || peer == nullptr || peer->isMinimised())
+        refreshHz = hiddenRefreshHz;
+    else if (now - lastKnobChangeTime < activityHoldMs)
+        refreshHz = activeRefreshHz;
+
+    if (getTimerInterval() != 1000 / refreshHz)
+        startTimerHz(refreshHz);
+}
+
+void JP8080ControllerAudioProcessorEditor::updateConnectionStatus()
+{
+    using State = JP8080ConnectionMonitor::State;
+    const auto& monitor = audioProcessor.getConnectionMonitor();
+
+    switch (monitor.getState())
+    {
+        case State::connected:
+        {
+            int roundTripMs = monitor.getRoundTripMs();
+            connectionStatusLabel.setText (roundTripMs >= 0 ? "Connected (" + juce::String (roundTripMs) + " ms)"
+                                                            : "Connected",
+                                           juce::dontSendNotification);
+            connectionStatusLabel.setColour (juce::Label::textColourId, juce::Colours::limegreen);
+            break;
+        }
+
+        case State::disconnected:
+            connectionStatusLabel.setText ("Disconnected", juce::dontSendNotification);
+            connectionStatusLabel.setColour (juce::Label::textColourId, juce::Colours::red);
+            break;
+
+        case State::unknown:
+        default:
+            connectionStatusLabel.setText ("No MIDI input", juce::dontSendNotification);
+            connectionStatusLabel.setColour (juce::Label::textColourId, juce::Colours::grey);
+            break;
+    }
+}
+
+void JP8080ControllerAudioProcessorEditor::updateTransferControls()
+{
+    auto& bulkTransfer = audioProcessor.getBulkTransfer();
+    const bool running = bulkTransfer.isRunning();
+
+    transferProgress = bulkTransfer.getProgress();
+    transferProgressBar.setTextToDisplay(running ? juce::String() : bulkTransfer.getStatusText());
+    transferProgressBar.setVisible(running || bulkTransfer.getStatusText().isNotEmpty());
+
+    backupButton.setEnabled(!running);
+    restoreButton.setEnabled(!running);
+    readPatchesButton.setEnabled(!running);
+    cancelTransferButton.setVisible(running);
+}
+
+void JP8080ControllerAudioProcessorEditor::updateHistoryControls()
+{
+    auto& history = audioProcessor.getSnapshotHistory();
+
+    undoButton.setEnabled(history.canUndo());
+    redoButton.setEnabled(history.canRedo());
+
+    // Shows the sound being edited; "Copy" copies it to the other one
+    compareButton.setButtonText(history.getActiveSlot() == 0 ? "A" : "B");
+}
+
+void JP8080ControllerAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+    if (! event.mods.isPopupMenu() || event.eventComponent == this)
+        return;
+
+    const auto paramID = event.eventComponent->getProperties()["paramID"].toString();
+    if (paramID.isNotEmpty())
+        showMidiLearnMenu(paramID, *event.eventComponent);
+}
+
+void JP8080ControllerAudioProcessorEditor::showMidiLearnMenu(const juce::String& paramID, juce::Component& target)
+{
+    auto& midiLearn = audioProcessor.getMidiLearn();
+    const auto route = midiLearn.getRouteDescription(paramID);
+    const int transmitCC = midiLearn.getTransmitCC(paramID);
+    const int defaultCC = getCCNumber(paramID);
+
+    enum MenuItem { learn = 1, forget, defaultTransmitCC, transmitOff, firstTransmitCC = 100 };
+
+    // CCs in groups of 16, so the list fits on screen
+    juce::PopupMenu transmitMenu;
+    transmitMenu.addItem(defaultTransmitCC, "Default (CC " + juce::String(defaultCC) + ")", true, transmitCC == defaultCC);
+    transmitMenu.addItem(transmitOff, "Off", true, transmitCC < 0);
+
+    for (int group = 0; group < 128; group += 16)
+    {
+        juce::PopupMenu groupMenu;
+        for (int cc = group; cc < group + 16; ++cc)
+            groupMenu.addItem(firstTransmitCC + cc, "CC " + juce::String(cc), true, transmitCC == cc);
+
+        transmitMenu.addSubMenu("CC " + juce::String(group) + "-" + juce::String(group + 15), groupMenu,
+                                true, juce::Image(), transmitCC >= group && transmitCC < group + 16);
+    }
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader(getDisplayName(paramID));
+    menu.addItem(learn, midiLearn.isLearning(paramID) ? "Cancel MIDI Learn" : "MIDI Learn");
+    menu.addItem(forget, route.isEmpty() ? juce::String("Forget MIDI Learn") : "Forget MIDI Learn (" + route + ")",
+                 route.isNotEmpty());
+    menu.addSubMenu("Transmit CC", transmitMenu);
+
+    juce::Component::SafePointer<JP8080ControllerAudioProcessorEditor> safeThis (this);
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&target),
+                       [safeThis, paramID, defaultCC](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+
+        auto& midiLearn = safeThis->audioProcessor.getMidiLearn();
+
+        if (result == learn)
+        {
+            // The next CC from a controller is routed to this parameter
+            if (midiLearn.isLearning(paramID))
+                midiLearn.stopLearning();
+            else
+                midiLearn.startLearning(paramID);
+        }
+        else if (result == forget)
+        {
+            midiLearn.removeRoutes(paramID);
+        }
+        else if (result == defaultTransmitCC)
+        {
+            midiLearn.setTransmitCC(paramID, defaultCC);
+        }
+        else if (result == transmitOff)
+        {
+            midiLearn.setTransmitCC(paramID, -1);
+        }
+        else
+        {
+            midiLearn.setTransmitCC(paramID, result - firstTransmitCC);
+        }
+    });
+}
+
+void JP8080ControllerAudioProcessorEditor::updateSceneControls()
+{
+    // Store needs a scene selected; Clear only when it holds something
+    const int sceneIndex = sceneCombo.getSelectedItemIndex() - 1;
+
+    storeSceneButton.setEnabled(sceneIndex >= 0);
+    clearSceneButton.setEnabled(audioProcessor.getSceneBank().hasScene(sceneIndex));
+}
+
 void JP8080ControllerAudioProcessorEditor::comboBoxChanged(juce::ComboBox* comboBox)
 {
     if (comboBox == &patchBankCombo)
     {
         updatePatchNamesForCurrentBank();
     }
+    else if (comboBox == &sceneCombo)
+    {
+        updateSceneControls();
+    }
     else if (comboBox == &midiOutputCombo)
     {
         int selectedId = midiOutputCombo.getSelectedId();
@@ -521,6 +878,26 @@ void JP8080ControllerAudioProcessorEditor::comboBoxChanged(juce::ComboBox* combo
             }
         }
     }
+    else if (comboBox == &midiInputCombo)
+    {
+        int selectedId = midiInputCombo.getSelectedId();
+
+        if (selectedId <= 1)
+        {
+            // "None" selected - close the input
+            audioProcessor.setSelectedMidiInput("");
+        }
+        else
+        {
+            auto midiInputs = audioProcessor.getAvailableMidiInputs();
+            int index = selectedId - 2; // Offset for "None" item
+
+            if (index >= 0 && index < midiInputs.size())
+            {
+                audioProcessor.setSelectedMidiInput(midiInputs[index].identifier);
+            }
+        }
+    }
 }
 
 void JP8080ControllerAudioProcessorEditor::updatePatchNamesForCurrentBank()
@@ -539,7 +916,18 @@ void JP8080ControllerAudioProcessorEditor::updatePatchNamesForCurrentBank()
 
     // Clear and repopulate the patch name ComboBox
     patchNameCombo.clear(juce::dontSendNotification);
-    patchNameCombo.addItemList(getPatchNamesForBank(bank), 1);
+
+    // Prefer names read from the hardware, keeping the A11-B88 number prefix
+    const auto& defaultNames = getPatchNamesForBank(bank);
+    auto& patchCache = audioProcessor.getPatchCache();
+
+    for (int program = 0; program < defaultNames.size(); ++program)
+    {
+        auto cachedName = patchCache.getPatchName(bankIndex, program);
+        patchNameCombo.addItem(cachedName.isNotEmpty() ? defaultNames[program].substring(0, 4) + cachedName
+                                                       : defaultNames[program],
+                               program + 1);
+    }
 
     // Restore the program selection (or select first if invalid)
     if (currentProgram >= 0 && currentProgram < 64)
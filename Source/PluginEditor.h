@@ -4,6 +4,8 @@
 #include "PluginProcessor.h"
 #include "JP8080Parameters.h"
 #include "JP8080LookAndFeel.h"
+#include "JP8080KnobAttachment.h"
+#include "JP8080DiagnosticsOverlay.h"
 
 //==============================================================================
 /**
@@ -12,7 +14,9 @@
  * Phase 4B: Custom JP-8080-style graphics and rotary knobs
  */
 class JP8080ControllerAudioProcessorEditor  : public juce::AudioProcessorEditor,
-                                             private juce::ComboBox::Listener
+                                             private juce::ComboBox::Listener,
+                                             private juce::Button::Listener,
+                                             private juce::Timer
 {
 public:
     JP8080ControllerAudioProcessorEditor (JP8080ControllerAudioProcessor&);
@@ -22,17 +26,30 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
+    // Right-click on a knob: MIDI learn and its transmit CC
+    void mouseDown (const juce::MouseEvent& event) override;
+
 private:
     JP8080ControllerAudioProcessor& audioProcessor;
     JP8080LookAndFeel jp8080LookAndFeel;
 
-    // Helper to create a labeled rotary knob
-    void createRotaryKnob(juce::Slider& slider, juce::Label& label,
-                         const juce::String& paramID, const juce::String& labelText);
+    // Panels, titles and control labels, cached at the display scale
+    void paintBackground (juce::Graphics& g);
+    juce::Image backgroundImage;
+    float backgroundScale = 1.0f;
+
+    // Creates the knobs and choice combos of every section
+    void createSections();
+
+    // Helper to create a rotary knob attached to a parameter
+    void createRotaryKnob(juce::Slider& slider, const juce::String& paramID);
 
     // ComboBox listener callback
     void comboBoxChanged(juce::ComboBox* comboBox) override;
 
+    // Button listener callback
+    void buttonClicked(juce::Button* button) override;
+
     // Helper to update patch name ComboBox based on current bank
     void updatePatchNamesForCurrentBank();
 
@@ -41,6 +58,72 @@ private:
     juce::ComboBox midiOutputCombo;
     void populateMidiOutputList();
 
+    juce::Label midiInputLabel;
+    juce::ComboBox midiInputCombo;
+    void populateMidiInputList();
+
+    // Reads all user patches into the patch cache
+    juce::TextButton readPatchesButton { "Read Patches" };
+
+    // Backup / restore of the user memory as .syx
+    juce::TextButton backupButton { "Backup..." };
+    juce::TextButton restoreButton { "Restore..." };
+    juce::TextButton cancelTransferButton { "Cancel" };
+    double transferProgress = 0.0;
+    juce::ProgressBar transferProgressBar { transferProgress };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    // Device lists are repopulated when discovery reports a change
+    int deviceListGeneration = 0;
+
+    // Records all MIDI traffic to a trace file while toggled on
+    juce::TextButton traceButton { "Trace" };
+
+    // Undo history and A/B compare
+    juce::TextButton undoButton { "Undo" };
+    juce::TextButton redoButton { "Redo" };
+    juce::TextButton compareButton { "A" };
+    juce::TextButton copySlotButton { "Copy" };
+    void updateHistoryControls();
+
+    // Scene selector, and storing the current sound into the selected scene
+    juce::ComboBox sceneCombo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sceneAttachment;
+    juce::TextButton storeSceneButton { "Store" };
+    juce::TextButton clearSceneButton { "Clear" };
+    void updateSceneControls();
+
+    void showMidiLearnMenu (const juce::String& paramID, juce::Component& target);
+
+    // Message counters and timing, shown over the panels on demand
+    juce::TextButton diagnosticsButton { "Diagnostics" };
+    JP8080DiagnosticsOverlay diagnosticsOverlay { audioProcessor.getMetrics() };
+
+    // Hardware connection state and round-trip latency
+    juce::Label connectionStatusLabel;
+    void updateConnectionStatus();
+
+    // Opt-in: hold output while the synth's Active Sensing has stopped
+    juce::ToggleButton pauseWhenDisconnectedButton { "Hold output while the synth is offline" };
+
+    // Refresh timer: applies knob parameter changes flagged by the processor
+    // once per frame, and polls the bulk transfer progress and connection state
+    void timerCallback() override;
+    bool updateKnobsFromParameters();
+    void updateRefreshRate(bool knobsChanged);
+    void updateTransferControls();
+
+    static constexpr int maxKnobParameters = 64;
+    std::array<JP8080KnobAttachment*, maxKnobParameters> knobAttachmentsByIndex {};
+
+    static constexpr int activeRefreshHz = 60;          // While parameters are moving
+    static constexpr int idleRefreshHz = 30;
+    static constexpr int hiddenRefreshHz = 5;           // Minimised or not on screen
+    static constexpr juce::uint32 activityHoldMs = 500;
+    static constexpr juce::uint32 statusPollIntervalMs = 200;
+    juce::uint32 lastKnobChangeTime = 0;
+    juce::uint32 lastStatusPollTime = 0;
+
     juce::Label partLabel;
     juce::ComboBox partCombo;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> partAttachment;
@@ -53,73 +136,14 @@ private:
     juce::ComboBox patchNameCombo;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> patchNameAttachment;
 
-    // Oscillator Section
-    juce::Label osc1WaveformLabel;
-    juce::ComboBox osc1WaveformCombo;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> osc1WaveformAttachment;
-
-    juce::Label osc1Control1Label, osc1Control2Label;
-    juce::Slider osc1Control1Knob, osc1Control2Knob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> osc1Control1Attachment, osc1Control2Attachment;
-
-    juce::Label osc2WaveformLabel;
-    juce::ComboBox osc2WaveformCombo;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> osc2WaveformAttachment;
-
-    juce::Label osc2RangeLabel, osc2FineLabel, osc2Control1Label, osc2Control2Label;
-    juce::Slider osc2RangeKnob, osc2FineKnob, osc2Control1Knob, osc2Control2Knob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> osc2RangeAttachment, osc2FineAttachment,
-                                                                            osc2Control1Attachment, osc2Control2Attachment;
-
-    juce::Label oscBalanceLabel, xModDepthLabel, oscLfo1DepthLabel;
-    juce::Slider oscBalanceKnob, xModDepthKnob, oscLfo1DepthKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> oscBalanceAttachment, xModDepthAttachment,
-                                                                            oscLfo1DepthAttachment;
-
-    // Filter Section
-    juce::Label filterCutoffLabel, filterResonanceLabel, filterKeyFollowLabel, filterLfo1DepthLabel, filterEnvDepthLabel;
-    juce::Slider filterCutoffKnob, filterResonanceKnob, filterKeyFollowKnob, filterLfo1DepthKnob, filterEnvDepthKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterCutoffAttachment, filterResonanceAttachment,
-                                                                            filterKeyFollowAttachment, filterLfo1DepthAttachment,
-                                                                            filterEnvDepthAttachment;
-
-    // Filter Envelope
-    juce::Label filterAttackLabel, filterDecayLabel, filterSustainLabel, filterReleaseLabel;
-    juce::Slider filterAttackKnob, filterDecayKnob, filterSustainKnob, filterReleaseKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterAttackAttachment, filterDecayAttachment,
-                                                                            filterSustainAttachment, filterReleaseAttachment;
-
-    // Amplifier Envelope
-    juce::Label ampLevelLabel, ampAttackLabel, ampDecayLabel, ampSustainLabel, ampReleaseLabel;
-    juce::Slider ampLevelKnob, ampAttackKnob, ampDecayKnob, ampSustainKnob, ampReleaseKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> ampLevelAttachment, ampAttackAttachment,
-                                                                            ampDecayAttachment, ampSustainAttachment,
-                                                                            ampReleaseAttachment;
-
-    // LFO Section
-    juce::Label lfo1WaveformLabel;
-    juce::ComboBox lfo1WaveformCombo;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> lfo1WaveformAttachment;
-
-    juce::Label lfo1RateLabel, lfo1FadeLabel, lfo2RateLabel, lfo2DepthLabel;
-    juce::Slider lfo1RateKnob, lfo1FadeKnob, lfo2RateKnob, lfo2DepthKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lfo1RateAttachment, lfo1FadeAttachment,
-                                                                            lfo2RateAttachment, lfo2DepthAttachment;
-
-    // Pitch Envelope Section
-    juce::Label pitchEnvDepthLabel, pitchEnvAttackLabel, pitchEnvDecayLabel;
-    juce::Slider pitchEnvDepthKnob, pitchEnvAttackKnob, pitchEnvDecayKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> pitchEnvDepthAttachment, pitchEnvAttackAttachment,
-                                                                            pitchEnvDecayAttachment;
-
-    // Effects Section
-    juce::Label toneCtrlBassLabel, toneCtrlTrebleLabel, multiFxTypeLabel, multiFxLevelLabel, delayTypeLabel, delayTimeLabel, delayFeedbackLabel, delayLevelLabel;
-    juce::ComboBox multiFxTypeCombo, delayTypeCombo;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> multiFxTypeAttachment, delayTypeAttachment;
-    juce::Slider toneCtrlBassKnob, toneCtrlTrebleKnob, multiFxLevelKnob, delayTimeKnob, delayFeedbackKnob, delayLevelKnob;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> toneCtrlBassAttachment, toneCtrlTrebleAttachment,
-                                                                            multiFxLevelAttachment, delayTimeAttachment,
-                                                                            delayFeedbackAttachment, delayLevelAttachment;
+    // Parameter sections, built from the descriptor tables in PluginEditor.cpp.
+    // Controls live in one contiguous array per type, in table order; their
+    // labels are drawn in paint() rather than being components.
+    std::unique_ptr<juce::Slider[]> knobs;
+    std::vector<std::unique_ptr<JP8080KnobAttachment>> knobAttachments;
+
+    std::unique_ptr<juce::ComboBox[]> choiceCombos;
+    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>> choiceAttachments;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080ControllerAudioProcessorEditor)
 };
@@ -24,6 +24,31 @@ JP8080ControllerAudioProcessor::JP8080ControllerAudioProcessor()
     apvts.addParameterListener(Oscillator::osc2Waveform, this);
     apvts.addParameterListener(LFO::lfo1Waveform, this);
 
+    // Add listeners for patch selection (recall from the patch cache)
+    apvts.addParameterListener(MidiConfig::patchBank, this);
+    apvts.addParameterListener(MidiConfig::patchProgram, this);
+
+    // Add listeners for the knob parameters (editor refresh)
+    const auto knobParameterIDs = getAllParameterIDs();
+    for (int i = 0; i < static_cast<int>(knobParameterIDs.size()); ++i)
+    {
+        knobParameterIndices[knobParameterIDs[static_cast<size_t>(i)]] = i;
+        apvts.addParameterListener(knobParameterIDs[static_cast<size_t>(i)], this);
+    }
+
+    // Undo and A/B recalls go out as one compiled burst of CCs and DT1s
+    snapshotHistory.onValuesRecalled = [this] { parameterJumpRequested = true; };
+
+    // Lock sequencer edits sent over OSC
+    oscServer.onLockEdit = [this] (const JP8080LockSequencer::Edit& edit) { lockSequencer.apply(edit); };
+
+    // Lock steps hold their CCs precompiled
+    midiLearn.onTransmitMapChanged = [this] { lockSequencer.recompile(); };
+
+    // Resend everything once a dropped hardware link comes back
+    connectionMonitor.onReconnected = [this] { resyncRequested = true; };
+
+    deviceDiscovery->addChangeListener(this);
 }
 
 JP8080ControllerAudioProcessor::~JP8080ControllerAudioProcessor()
@@ -34,10 +59,37 @@ JP8080ControllerAudioProcessor::~JP8080ControllerAudioProcessor()
     apvts.removeParameterListener(Oscillator::osc1Waveform, this);
     apvts.removeParameterListener(Oscillator::osc2Waveform, this);
     apvts.removeParameterListener(LFO::lfo1Waveform, this);
+    apvts.removeParameterListener(MidiConfig::patchBank, this);
+    apvts.removeParameterListener(MidiConfig::patchProgram, this);
+
+    for (const auto& [paramID, index] : knobParameterIndices)
+    {
+        juce::ignoreUnused(index);
+        apvts.removeParameterListener(paramID, this);
+    }
+
+    deviceDiscovery->removeChangeListener(this);
+    deviceDiscovery->setPortsInUse(this, {}, {});
+
+    // Stop background work before the MIDI devices go away
+    sysExQueue.stop();
+    connectionMonitor.setEnabled(false, sysexDeviceId);
+    bulkTransfer.stop();
+    patchCacheFillThread.stopThread(2000);
+    traceRecorder.stop();
+    stopTimer();
+    cancelPendingUpdate();
+
+    // Close direct MIDI input first so no callbacks arrive during destruction
+    if (directMidiInput)
+        directMidiInput.reset();
 
     // Close direct MIDI output
+    directMidiOutputOpen = false;
     if (directMidiOutput)
         directMidiOutput.reset();
+
+    patchCache->saveToFile();
 }
 
 //==============================================================================
@@ -45,7 +97,8 @@ JP8080ControllerAudioProcessor::~JP8080ControllerAudioProcessor()
 
 juce::Array<juce::MidiDeviceInfo> JP8080ControllerAudioProcessor::getAvailableMidiOutputs() const
 {
-    return juce::MidiOutput::getAvailableDevices();
+    // Cached by the discovery service, never queries the OS on the caller's thread
+    return deviceDiscovery->getOutputs();
 }
 
 juce::String JP8080ControllerAudioProcessor::getSelectedMidiOutputName() const
@@ -57,7 +110,7 @@ juce::String JP8080ControllerAudioProcessor::getSelectedMidiOutputName() const
         return "No device selected";
 
     // Try to find the name from the ID
-    auto devices = juce::MidiOutput::getAvailableDevices();
+    auto devices = deviceDiscovery->getOutputs();
     for (const auto& device : devices)
     {
         if (device.identifier == selectedMidiOutputId)
@@ -74,15 +127,27 @@ void JP8080ControllerAudioProcessor::setSelectedMidiOutput(const juce::String& d
 
     selectedMidiOutputId = deviceId;
 
-    // Close existing output
-    if (directMidiOutput)
-        directMidiOutput.reset();
-
-    // Open new output
-    if (deviceId.isNotEmpty())
     {
-        directMidiOutput = juce::MidiOutput::openDevice(deviceId);
+        const juce::ScopedLock sl (directMidiOutputLock);
+
+        // Close existing output
+        if (directMidiOutput)
+            directMidiOutput.reset();
+
+        // Open new output
+        if (deviceId.isNotEmpty())
+        {
+            directMidiOutput = juce::MidiOutput::openDevice(deviceId);
+        }
+
+        directMidiOutputOpen = directMidiOutput != nullptr;
     }
+
+    deviceDiscovery->setPortsInUse(this, selectedMidiOutputId, selectedMidiInputId);
+    updateConnectionMonitor();
+
+    if (isPatchCacheFillNeeded())
+        requestPatchCacheFill();
 }
 
 void JP8080ControllerAudioProcessor::refreshMidiOutput()
@@ -90,21 +155,523 @@ void JP8080ControllerAudioProcessor::refreshMidiOutput()
     // Re-open the currently selected device (useful if devices change)
     if (selectedMidiOutputId.isNotEmpty())
     {
+        const juce::ScopedLock sl (directMidiOutputLock);
+
         if (directMidiOutput)
             directMidiOutput.reset();
 
         directMidiOutput = juce::MidiOutput::openDevice(selectedMidiOutputId);
+        directMidiOutputOpen = directMidiOutput != nullptr;
+    }
+}
+
+void JP8080ControllerAudioProcessor::sendSysExDirect(const std::vector<uint8_t>& sysexData,
+                                                     juce::int64 samplePosition, int parameterIndex)
+{
+    writeSysExToOutput(sysexData, samplePosition, parameterIndex, juce::Time::getHighResolutionTicks());
+}
+
+void JP8080ControllerAudioProcessor::queueSysExDirect(const std::vector<uint8_t>& sysexData,
+                                                      juce::int64 samplePosition, int parameterIndex)
+{
+    // Offline render runs processBlock on its own thread and wants the SysEx in order, synchronously
+    if (sysExCapture)
+    {
+        sysExCapture(sysexData, samplePosition);
+        metrics.countSent(JP8080Metrics::sysEx);
+        return;
     }
+
+    if (!sysExQueue.push(sysexData, samplePosition, parameterIndex))
+        metrics.countDropped();
 }
 
-void JP8080ControllerAudioProcessor::sendSysExDirect(const std::vector<uint8_t>& sysexData)
+void JP8080ControllerAudioProcessor::writeSysExToOutput(const std::vector<uint8_t>& sysexData, juce::int64 samplePosition,
+                                                        int parameterIndex, juce::int64 startTicks)
 {
+    const juce::ScopedLock sl (directMidiOutputLock);
+
+    if (sysExCapture)
+    {
+        sysExCapture(sysexData, samplePosition);
+        metrics.countSent(JP8080Metrics::sysEx);
+        return;
+    }
+
     if (!directMidiOutput)
+    {
+        metrics.countDropped();
         return;
+    }
 
     // Create the MIDI message (JUCE adds F0/F7 automatically)
     auto message = juce::MidiMessage::createSysExMessage(sysexData.data(), static_cast<int>(sysexData.size()));
     directMidiOutput->sendMessageNow(message);
+
+    // Latency includes time queued and waiting for another thread's send to finish
+    metrics.sysExSendLatency.record(JP8080Metrics::ticksToMicros(juce::Time::getHighResolutionTicks() - startTicks));
+    metrics.countSent(JP8080Metrics::sysEx);
+    traceRecorder.record(JP8080TraceRecorder::outgoing, message.getRawData(), message.getRawDataSize(),
+                         samplePosition, parameterIndex);
+}
+
+void JP8080ControllerAudioProcessor::sendMidiBufferDirect(const juce::MidiBuffer& midiMessages)
+{
+    if (midiMessages.isEmpty())
+        return;
+
+    const juce::ScopedLock sl (directMidiOutputLock);
+
+    // Every message was counted as sent and traced by processBlock
+    for (const auto metadata : midiMessages)
+    {
+        if (directMidiOutput)
+            directMidiOutput->sendMessageNow(metadata.getMessage());
+        else
+            metrics.countDropped();
+    }
+}
+
+void JP8080ControllerAudioProcessor::setSysExCapture(SysExCapture capture)
+{
+    const juce::ScopedLock sl (directMidiOutputLock);
+    sysExCapture = std::move(capture);
+}
+
+//==============================================================================
+// MIDI traffic trace
+
+bool JP8080ControllerAudioProcessor::startTraceRecording()
+{
+    auto traceFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                         .getChildFile("JP8080Controller")
+                         .getChildFile("Traces")
+                         .getChildFile("trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".jp8trace");
+
+    return traceRecorder.start(traceFile, getSampleRate());
+}
+
+void JP8080ControllerAudioProcessor::stopTraceRecording()
+{
+    traceRecorder.stop();
+}
+
+//==============================================================================
+// OSC control
+
+bool JP8080ControllerAudioProcessor::setOSCPort(int port)
+{
+    if (port == getOSCPort())
+        return true;
+
+    if (port <= 0)
+    {
+        oscServer.stop();
+        return true;
+    }
+
+    return oscServer.start(port);
+}
+
+//==============================================================================
+// Direct MIDI Input (SysEx replies from the JP-8080)
+
+juce::Array<juce::MidiDeviceInfo> JP8080ControllerAudioProcessor::getAvailableMidiInputs() const
+{
+    return deviceDiscovery->getInputs();
+}
+
+void JP8080ControllerAudioProcessor::setSelectedMidiInput(const juce::String& deviceId)
+{
+    if (deviceId == selectedMidiInputId && directMidiInput != nullptr)
+        return; // Already using this device
+
+    selectedMidiInputId = deviceId;
+
+    // Close existing input
+    if (directMidiInput)
+        directMidiInput.reset();
+
+    sysexReassembler.reset();
+
+    // Open and start new input
+    if (deviceId.isNotEmpty())
+    {
+        directMidiInput = juce::MidiInput::openDevice(deviceId, this);
+
+        if (directMidiInput)
+            directMidiInput->start();
+    }
+
+    deviceDiscovery->setPortsInUse(this, selectedMidiOutputId, selectedMidiInputId);
+    updateConnectionMonitor();
+
+    if (isPatchCacheFillNeeded())
+        requestPatchCacheFill();
+}
+
+void JP8080ControllerAudioProcessor::handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message)
+{
+    juce::ignoreUnused(source);
+
+    connectionMonitor.noteIncomingMessage(message.isActiveSense());
+    traceRecorder.record(JP8080TraceRecorder::incoming, message.getRawData(), message.getRawDataSize());
+
+    // Partial SysEx packets are reassembled by JUCE and delivered here as one
+    // message. Feed the raw bytes straight into the reassembler, which validates
+    // them in place and only buffers fragments.
+    if (message.isSysEx())
+        sysexReassembler.processBytes(message.getRawData(), message.getRawDataSize());
+}
+
+void JP8080ControllerAudioProcessor::handleDataSet (const JP8080SysEx::DataSet& dataSet,
+                                                    const uint8_t* sysexData, int sysexSize)
+{
+    connectionMonitor.handleDataSet(dataSet);
+    bulkTransfer.handleIncomingDataSet(dataSet, sysexData, sysexSize);
+    handleIncomingDataSet(dataSet);
+}
+
+void JP8080ControllerAudioProcessor::updateConnectionMonitor()
+{
+    // Monitoring needs both directions to the same synth
+    connectionMonitor.setEnabled(directMidiInput != nullptr && directMidiOutput != nullptr,
+                                 sysexDeviceId);
+}
+
+//==============================================================================
+// Device Discovery
+
+bool JP8080ControllerAudioProcessor::isJP8080Port(const juce::String& deviceId) const
+{
+    for (const auto& synth : deviceDiscovery->getSynths())
+    {
+        if (synth.output.identifier == deviceId || synth.input.identifier == deviceId)
+            return true;
+    }
+
+    return false;
+}
+
+void JP8080ControllerAudioProcessor::setSysExDeviceId(uint8_t newDeviceId)
+{
+    newDeviceId = juce::jlimit(JP8080SysEx::minDeviceId, JP8080SysEx::maxDeviceId, newDeviceId);
+
+    if (sysexDeviceId.exchange(newDeviceId) == newDeviceId)
+        return;
+
+    sysexReassembler.setDeviceId(newDeviceId);
+    lockSequencer.recompile();
+    updateConnectionMonitor();
+}
+
+void JP8080ControllerAudioProcessor::changeListenerCallback (juce::ChangeBroadcaster* source)
+{
+    juce::ignoreUnused(source);
+
+    auto containsId = [](const juce::Array<juce::MidiDeviceInfo>& devices, const juce::String& id)
+    {
+        for (const auto& device : devices)
+            if (device.identifier == id)
+                return true;
+
+        return false;
+    };
+
+    const bool outputPresent = containsId(deviceDiscovery->getOutputs(), selectedMidiOutputId);
+    const bool inputPresent = containsId(deviceDiscovery->getInputs(), selectedMidiInputId);
+    const auto synths = deviceDiscovery->getSynths();
+
+    // Reopen ports that came back under the same identifier (hot-plug)
+    if (outputPresent && !selectedOutputPresent)
+        refreshMidiOutput();
+
+    if (inputPresent && !selectedInputPresent)
+    {
+        auto inputId = selectedMidiInputId;
+        selectedMidiInputId.clear();
+        setSelectedMidiInput(inputId);
+    }
+
+    selectedOutputPresent = outputPresent;
+    selectedInputPresent = inputPresent;
+
+    for (const auto& synth : synths)
+    {
+        // Selected ports lead to a JP-8080: use its device ID
+        if (synth.output.identifier == selectedMidiOutputId)
+        {
+            if (selectedMidiInputId.isEmpty() || !inputPresent)
+                setSelectedMidiInput(synth.input.identifier);
+
+            setSysExDeviceId(synth.deviceId);
+            return;
+        }
+    }
+
+    for (const auto& synth : synths)
+    {
+        // Configured synth reappeared under a different port name
+        if (selectedMidiOutputId.isNotEmpty() && !outputPresent && synth.deviceId == sysexDeviceId.load())
+        {
+            setSelectedMidiOutput(synth.output.identifier);
+            setSelectedMidiInput(synth.input.identifier);
+            setSysExDeviceId(synth.deviceId);
+            selectedOutputPresent = selectedInputPresent = true;
+            return;
+        }
+    }
+}
+
+void JP8080ControllerAudioProcessor::handleIncomingDataSet (const JP8080SysEx::DataSet& dataSet)
+{
+    int patchIndex = 0, partIndex = 0, offset = 0;
+
+    if (JP8080SysEx::decodeUserPatchAddress(dataSet.address, patchIndex, offset))
+    {
+        // User patch data (bulk dump reply, or a patch written on the hardware)
+        bool complete = patchCache->writePatchData(patchIndex / JP8080PatchCache::numPrograms,
+                                                   patchIndex % JP8080PatchCache::numPrograms,
+                                                   offset, dataSet.data, dataSet.size);
+
+        if (complete && offset + dataSet.size >= JP8080SysEx::patchSize)
+            patchReceived.signal();
+    }
+    else if (JP8080SysEx::decodeTemporaryPatchAddress(dataSet.address, partIndex, offset))
+    {
+        // Temporary patch reply after a program change
+        int slot = temporaryCaptureSlot.load();
+
+        if (slot >= 0 && partIndex == getSelectedPartIndex())
+        {
+            if (patchCache->writePatchData(slot / JP8080PatchCache::numPrograms,
+                                           slot % JP8080PatchCache::numPrograms,
+                                           offset, dataSet.data, dataSet.size))
+            {
+                capturedPatchSlot = slot;
+                temporaryCaptureSlot = -1;
+                triggerAsyncUpdate();
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Patch Cache
+
+bool JP8080ControllerAudioProcessor::isPatchCacheFillNeeded() const
+{
+    if (directMidiInput == nullptr || directMidiOutput == nullptr || patchCacheFillThread.isThreadRunning())
+        return false;
+
+    // Only the user area can be read via SysEx; preset banks fill as they are recalled
+    for (int program = 0; program < JP8080PatchCache::numPrograms; ++program)
+    {
+        if (!patchCache->isCached(static_cast<int>(JP8080Parameters::PatchBank::UserA), program) ||
+            !patchCache->isCached(static_cast<int>(JP8080Parameters::PatchBank::UserB), program))
+            return true;
+    }
+
+    return false;
+}
+
+void JP8080ControllerAudioProcessor::requestPatchCacheFill()
+{
+    if (directMidiInput == nullptr || directMidiOutput == nullptr || bulkTransfer.isRunning())
+        return;
+
+    patchCacheFillThread.startThread();
+}
+
+void JP8080ControllerAudioProcessor::PatchCacheFillThread::run()
+{
+    using namespace JP8080SysEx;
+
+    for (int patchIndex = 0; patchIndex < numUserPatches && !threadShouldExit(); ++patchIndex)
+    {
+        processor.patchReceived.reset();
+        processor.sendSysExDirect(createDataRequest(processor.sysexDeviceId, getUserPatchAddress(patchIndex), patchSize));
+
+        // A 248-byte reply takes ~90 ms at 31.25 kbit/s. Move on after a timeout
+        // so a missing reply doesn't stall the dump.
+        processor.patchReceived.wait(patchReplyTimeoutMs);
+        wait(messageIntervalMs);
+    }
+
+    processor.patchCache->saveToFile();
+}
+
+//==============================================================================
+// Bulk Transfer
+
+bool JP8080ControllerAudioProcessor::startBackup(const juce::File& destination)
+{
+    // Backup needs replies from the hardware
+    if (directMidiInput == nullptr || directMidiOutput == nullptr)
+        return false;
+
+    // The backup refreshes the user patches in the cache as well
+    patchCacheFillThread.stopThread(2000);
+    return bulkTransfer.startBackup(destination, sysexDeviceId);
+}
+
+bool JP8080ControllerAudioProcessor::startRestore(const juce::File& source)
+{
+    if (directMidiOutput == nullptr)
+        return false;
+
+    patchCacheFillThread.stopThread(2000);
+    return bulkTransfer.startRestore(source, sysexDeviceId);
+}
+
+void JP8080ControllerAudioProcessor::sendDataSetToHardware(const std::vector<uint8_t>& sysexData)
+{
+    sendSysExDirect(sysexData);
+
+    // Written user patches replace their cached images
+    JP8080SysEx::DataSet dataSet;
+    if (JP8080SysEx::parseDataSet(sysexData.data(), static_cast<int>(sysexData.size()), dataSet))
+        handleIncomingDataSet(dataSet);
+}
+
+bool JP8080ControllerAudioProcessor::getSelectedPatchSlot (int& bank, int& program) const
+{
+    using namespace JP8080Parameters;
+
+    auto* bankParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(MidiConfig::patchBank));
+    auto* programParam = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter(MidiConfig::patchProgram));
+
+    if (bankParam == nullptr || programParam == nullptr)
+        return false;
+
+    bank = bankParam->getIndex();
+    program = programParam->get() - 1; // 1-64 to slot 0-63
+    return true;
+}
+
+int JP8080ControllerAudioProcessor::getSelectedPartIndex() const
+{
+    auto* partParam = apvts.getParameter(JP8080Parameters::MidiConfig::part);
+    return partParam != nullptr ? static_cast<int>(partParam->getValue() + 0.5f) : 0;
+}
+
+void JP8080ControllerAudioProcessor::handleAsyncUpdate()
+{
+    if (const int slot = capturedPatchSlot.exchange(-1); slot >= 0)
+        applyCapturedPatch(slot);
+
+    if (patchSelectionChanged.exchange(false))
+        recallPatchFromCache();
+}
+
+void JP8080ControllerAudioProcessor::recallPatchFromCache()
+{
+    int bank = 0, program = 0;
+    if (!getSelectedPatchSlot(bank, program))
+        return;
+
+    JP8080PatchCache::PatchImage image;
+    if (patchCache->getPatch(bank, program, image))
+    {
+        applyPatchImageToParameters(image);
+        appliedPatchSlot = bank * JP8080PatchCache::numPrograms + program;
+        appliedPatchImage = image;
+    }
+
+    // Read the temporary patch once the program change has reached the hardware:
+    // fills the cache, or catches a patch edited and written on the front panel
+    // since it was cached
+    if (directMidiInput != nullptr && directMidiOutput != nullptr)
+    {
+        pendingCaptureSlot = bank * JP8080PatchCache::numPrograms + program;
+        startTimer(temporaryPatchRequestDelayMs);
+    }
+}
+
+void JP8080ControllerAudioProcessor::timerCallback()
+{
+    stopTimer();
+
+    int bank = 0, program = 0;
+    int slot = pendingCaptureSlot.exchange(-1);
+
+    // Ignore if the selection moved on in the meantime
+    if (slot < 0 || !getSelectedPatchSlot(bank, program) || slot != bank * JP8080PatchCache::numPrograms + program)
+        return;
+
+    patchCache->restartCapture(bank, program);
+    temporaryCaptureSlot = slot;
+
+    sendSysExDirect(JP8080SysEx::createDataRequest(sysexDeviceId,
+                                                   JP8080SysEx::getTemporaryPatchAddress(getSelectedPartIndex()),
+                                                   JP8080SysEx::patchSize));
+}
+
+void JP8080ControllerAudioProcessor::applyCapturedPatch (int slot)
+{
+    int bank = 0, program = 0;
+
+    // The selection moved on while the patch was read
+    if (!getSelectedPatchSlot(bank, program) || slot != bank * JP8080PatchCache::numPrograms + program)
+        return;
+
+    JP8080PatchCache::PatchImage image;
+    if (!patchCache->getPatch(bank, program, image))
+        return;
+
+    // The cached copy was current: keep any edits made since the recall
+    if (slot == appliedPatchSlot && image == appliedPatchImage)
+        return;
+
+    applyPatchImageToParameters(image);
+    appliedPatchSlot = slot;
+    appliedPatchImage = image;
+}
+
+void JP8080ControllerAudioProcessor::applyPatchImageToParameters (const JP8080PatchCache::PatchImage& image)
+{
+    using namespace JP8080Parameters;
+
+    // Hold CC output while the values are swapped, processBlock releases it
+    suppressParameterOutput = true;
+
+    for (const auto& [paramID, offsetInfo] : patchOffsets)
+    {
+        auto* param = apvts.getParameter(paramID);
+        if (param == nullptr)
+            continue;
+
+        int patchValue = juce::jlimit(0, offsetInfo.maxValue, static_cast<int>(image[static_cast<size_t>(offsetInfo.offset)]));
+
+        // Choice parameters store the index directly, others are scaled to 0-127
+        int paramValue = dynamic_cast<juce::AudioParameterChoice*>(param) != nullptr
+                           ? patchValue
+                           : juce::roundToInt(patchValue * 127.0f / offsetInfo.maxValue);
+
+        param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(paramValue)));
+    }
+
+    adoptParametersAsSent = true;
+}
+
+void JP8080ControllerAudioProcessor::markPatchParametersAsSent()
+{
+    using namespace JP8080Parameters;
+
+    for (const auto& [paramID, offsetInfo] : patchOffsets)
+    {
+        juce::ignoreUnused(offsetInfo);
+        auto* param = apvts.getParameter(paramID);
+
+        if (auto* choiceParam = dynamic_cast<juce::AudioParameterChoice*>(param))
+            lastSentValues[paramID] = choiceParam->getIndex();
+        else if (param != nullptr)
+        {
+            const float plainValue = param->convertFrom0to1(param->getValue());
+            lastSentValues[paramID] = JP8080StepEmitter::toMidiValue(plainValue);
+            lastBlockValues[paramID] = plainValue;
+        }
+    }
 }
 
 //==============================================================================
@@ -115,6 +682,29 @@ void JP8080ControllerAudioProcessor::parameterChanged (const juce::String& param
     juce::ignoreUnused(newValue);
     using namespace JP8080Parameters;
 
+    // Knob parameter changed (possibly on the audio thread): flag it for the editor
+    auto knobIndex = knobParameterIndices.find(parameterID);
+    if (knobIndex != knobParameterIndices.end())
+    {
+        const auto bit = uint64_t(1) << knobIndex->second;
+        dirtyKnobParameters.fetch_or(bit);
+        pendingOutputMask.fetch_or(bit);
+        ++pendingOutputChanges;
+        return;
+    }
+
+    // Patch selection changed: recall the cached patch on the message thread
+    if (parameterID == MidiConfig::patchBank || parameterID == MidiConfig::patchProgram)
+    {
+        if (!restoringState)
+        {
+            patchSelectionChanged = true;
+            triggerAsyncUpdate();
+        }
+
+        return;
+    }
+
     // Check if this is a waveform parameter
     if (parameterID == Oscillator::osc1Waveform ||
         parameterID == Oscillator::osc2Waveform ||
@@ -206,7 +796,13 @@ void JP8080ControllerAudioProcessor::changeProgramName (int index, const juce::S
 //==============================================================================
 void JP8080ControllerAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused (sampleRate, samplesPerBlock);
+    juce::ignoreUnused (sampleRate);
+
+    midiClock.prepare (JP8080MidiClock::maxEventsPerBlock * 2);
+    burstChanges.reserve (JP8080Parameters::getAllParameterIDs().size());
+    outputBurst.prepare();
+    sysExScratch.reserve (JP8080SysExQueue::maxMessageSize);
+    filteredMidi.ensureSize (static_cast<size_t> (juce::jmax (samplesPerBlock, 256)) * 3);
 }
 
 void JP8080ControllerAudioProcessor::releaseResources()
@@ -234,18 +830,55 @@ bool JP8080ControllerAudioProcessor::isBusesLayoutSupported (const BusesLayout&
 }
 #endif
 
-void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
-                                                    juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
+                                                    juce::MidiBuffer& midiMessages)
+{
+    const JP8080Metrics::ScopedTimer blockTimer (metrics.processBlockTime);
+
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // Clear any output channels that don't contain input data
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    // Host timeline position of this block, for the traffic trace and the MIDI clock
+    currentPosition = {};
+    if (auto* playHead = getPlayHead())
+        currentPosition = playHead->getPosition();
+
+    currentBlockSamplePosition = currentPosition.hasValue() ? currentPosition->getTimeInSamples().orFallback(-1) : -1;
+
+    // Parameter changes received over OSC since the last block
+    oscServer.applyPendingChanges();
+
+    // Hardware controllers routed to parameters by MIDI learn
+    processMidiLearn(midiMessages);
+
+    // Scene switches and crossfades set parameters, so they come before the output
+    processScenes(midiMessages, buffer.getNumSamples());
+
+    // What is left of the input passes through to the synth; everything added
+    // from here on is counted and traced where it is created
+    for (const auto metadata : midiMessages)
+    {
+        metrics.countSent(JP8080Metrics::passThrough);
+        traceRecorder.record(JP8080TraceRecorder::outgoing, metadata.data, metadata.numBytes,
+                             currentBlockSamplePosition >= 0 ? currentBlockSamplePosition + metadata.samplePosition : -1);
+    }
+
+    // Notes and controllers passing through to the synth drive the modulation matrix
+    modMatrix.process(midiMessages);
 
-    // Clear any output channels that don't contain input data
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    processMidiOutput(midiMessages, buffer.getNumSamples());
+    processMidiClock(midiMessages, buffer.getNumSamples());
+
+    metrics.setOutputQueueDepth(midiMessages.getNumEvents());
+}
 
-    // MIDI output processing
+void JP8080ControllerAudioProcessor::processMidiOutput (juce::MidiBuffer& midiMessages, int numSamples)
+{
     using namespace JP8080Parameters;
 
     // Get Part selection and derive MIDI channel (Upper=1, Lower=2)
@@ -253,7 +886,36 @@ void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
     int partIndex = partParam != nullptr ? static_cast<int>(partParam->getValue() + 0.5f) : 0;
     int currentMidiChannel = (partIndex == 0) ? 1 : 2; // Upper=Ch1, Lower=Ch2
 
+    // Optionally don't queue messages into a dead port. Changes keep
+    // accumulating and are sent once the link is back.
+    if (isOutputPaused())
+        return;
+
+    // Link came back: forget what was sent so the full state goes out again
+    const bool resyncing = resyncRequested.exchange(false);
+    if (resyncing)
+    {
+        for (auto& sentValue : lastSentValues)
+            sentValue.second = -1;
+
+        lastSentBank = -1;
+        lastSentProgram = -1;
+        rpnSequencer.reset();
+        midiClock.reset();
+    }
+
+    // Parameters moved to another CC go out again on the new one
+    if (const auto remapped = std::bitset<64>(midiLearn.takeRemappedParameters()); remapped.any())
+    {
+        const auto knobParameterIDs = getAllParameterIDs();
+
+        for (size_t i = 0; i < knobParameterIDs.size(); ++i)
+            if (remapped[i])
+                lastSentValues[knobParameterIDs[i]] = -1;
+    }
+
     // Check for Bank Select + Program Change
+    bool programChangeQueued = false;
     auto* bankParam = apvts.getParameter(MidiConfig::patchBank);
     auto* programParam = apvts.getParameter(MidiConfig::patchProgram);
 
@@ -268,9 +930,38 @@ void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
             sendBankSelectAndProgramChange(midiMessages, currentBank, currentProgram, currentMidiChannel);
             lastSentBank = currentBank;
             lastSentProgram = currentProgram;
+            programChangeQueued = true;
         }
     }
 
+    // Changed RPNs as one uninterrupted unit: the whole group sits at sample 0
+    // ahead of any CC added later in this block
+    const int rpnUnitSize = rpnSequencer.process(currentMidiChannel, numSamples, getSampleRate(), rpnUnit);
+    for (int i = 0; i < rpnUnitSize; ++i)
+    {
+        const auto& cc = rpnUnit[static_cast<size_t>(i)];
+        sendMidiCC(midiMessages, cc.controller, cc.value, currentMidiChannel);
+    }
+
+    // Values recalled from the patch cache already match the hardware
+    if (adoptParametersAsSent.exchange(false))
+    {
+        markPatchParametersAsSent();
+        suppressParameterOutput = false;
+    }
+
+    if (suppressParameterOutput)
+        return;
+
+    // Several changes to one parameter since the last block go out as a single message
+    const int numChanges = pendingOutputChanges.exchange(0);
+    const auto changedParameters = std::bitset<64>(pendingOutputMask.exchange(0));
+    metrics.countCoalesced(numChanges - static_cast<int>(changedParameters.count()));
+
+    // Parameter locks of the steps starting in this block. Locked parameters
+    // are left alone below until their lock is released.
+    processLockSequencer(midiMessages, numSamples, partIndex, currentMidiChannel);
+
     // Check waveform and effect type parameters and send SysEx via direct MIDI output
     const std::array<juce::String, 5> sysexParamIDs = {
         Oscillator::osc1Waveform,
@@ -282,6 +973,9 @@ void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
 
     for (const auto& paramID : sysexParamIDs)
     {
+        if (activeLocks[static_cast<size_t>(JP8080LockSequencer::getLockIndex(paramID))])
+            continue;
+
         auto* param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramID));
         if (param != nullptr)
         {
@@ -302,10 +996,45 @@ void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
         }
     }
 
+    // Arpeggiator and tempo settings go to the temporary performance as SysEx
+    for (const auto& paramID : getAllPerformanceCommonParameterIDs())
+    {
+        auto* param = apvts.getParameter(paramID);
+        if (param == nullptr)
+            continue;
+
+        const int currentValue = juce::roundToInt(param->convertFrom0to1(param->getValue()));
+
+        auto it = lastSentValues.find(paramID);
+        if (it == lastSentValues.end() || it->second != currentValue)
+        {
+            sendPerformanceCommonSysEx(paramID, currentValue);
+            lastSentValues[paramID] = currentValue;
+        }
+    }
+
+    // Values recalled by undo or A/B are sent as they are, without sweeping to them,
+    // and together with a resync as one compiled burst
+    const bool jumpToValues = parameterJumpRequested.exchange(false);
+    const bool sendAsBurst = jumpToValues || resyncing;
+
+    // Bandwidth of the port for this block, shared between the parameters that moved
+    const int stepBudget = JP8080StepEmitter::getBlockBudget(getSampleRate(), numSamples)
+                             / juce::jmax(1, static_cast<int>(changedParameters.count()));
+
     // Send parameter changes as MIDI CC messages
     // Only send CC when parameter values have changed to avoid flooding MIDI output
+    int nextKnobIndex = 0; // Lock indices, the transmit map and modulation follow getAllParameterIDs()
+
     for (const auto& paramID : getAllParameterIDs())
     {
+        const int knobIndex = nextKnobIndex++;
+
+        if (activeLocks[static_cast<size_t>(knobIndex)])
+            continue;
+
+        const int ccNumber = midiLearn.getTransmitCC(knobIndex);
+
         auto* param = apvts.getParameter(paramID);
         if (param != nullptr)
         {
@@ -317,30 +1046,315 @@ void JP8080ControllerAudioProcessor::processBlock (juce::AudioBuffer<float>& buf
                 paramID == Effects::delayType)
                 continue;
 
-            // Get normalized value (0.0-1.0) and convert to MIDI range (0-127)
-            float normalizedValue = param->getValue();
-            int midiValue = static_cast<int>(normalizedValue * 127.0f);
+            // Not sent when its CC is switched off
+            if (ccNumber < 0 || ccNumber > 127)
+                continue;
+
+            // Plain value (0.0-127.0) plus its modulation, rounded to the nearest MIDI value
+            const float plainValue = juce::jlimit(0.0f, 127.0f, param->convertFrom0to1(param->getValue())
+                                                                  + modMatrix.getOffset(knobIndex));
+            int midiValue = JP8080StepEmitter::toMidiValue(plainValue);
 
-            // Check if value has changed since last sent
             auto it = lastSentValues.find(paramID);
-            bool valueChanged = (it == lastSentValues.end()) || (it->second != midiValue);
+            const int lastSentValue = it != lastSentValues.end() ? it->second : -1;
 
-            if (valueChanged)
+            if (sendAsBurst)
             {
-                // Get the CC number for this parameter
-                int ccNumber = getCCNumber(paramID);
+                lastBlockValues[paramID] = plainValue;
 
-                if (ccNumber >= 0 && ccNumber <= 127)
+                if (lastSentValue != midiValue)
                 {
-                    // Send the MIDI CC message using the selected MIDI channel
-                    sendMidiCC(midiMessages, ccNumber, midiValue, currentMidiChannel);
-
-                    // Update last sent value
+                    burstChanges.push_back(makeBurstChange(paramID, ccNumber, midiValue));
                     lastSentValues[paramID] = midiValue;
                 }
+
+                continue;
+            }
+
+            // Continuous parameters sweep through every step they cross, each
+            // at the sample where it is crossed
+            if (dynamic_cast<juce::AudioParameterFloat*>(param) != nullptr)
+            {
+                auto previous = lastBlockValues.find(paramID);
+                const float previousValue = (previous != lastBlockValues.end() && ! jumpToValues) ? previous->second : plainValue;
+                lastBlockValues[paramID] = plainValue;
+
+                const int numSteps = JP8080StepEmitter::planSteps(lastSentValue, previousValue, plainValue,
+                                                                  numSamples, stepBudget, plannedSteps);
+
+                for (int i = 0; i < numSteps; ++i)
+                {
+                    const auto& step = plannedSteps[static_cast<size_t>(i)];
+                    sendMidiCC(midiMessages, ccNumber, step.value, currentMidiChannel,
+                               param->getParameterIndex(), step.sampleOffset);
+                }
+
+                if (numSteps > 0)
+                    lastSentValues[paramID] = midiValue;
+
+                continue;
+            }
+
+            // Switches: send when the value has changed since last sent
+            if (lastSentValue != midiValue)
+            {
+                // Send the MIDI CC message using the selected MIDI channel
+                sendMidiCC(midiMessages, ccNumber, midiValue, currentMidiChannel, param->getParameterIndex());
+
+                // Update last sent value
+                lastSentValues[paramID] = midiValue;
+            }
+        }
+    }
+
+    // CCs or DT1 to the temporary patch, whichever is fewer bytes. DT1 needs
+    // the direct output (or the render capture), and it reaches the synth
+    // ahead of this block's MidiBuffer: after a program change in the same
+    // block the patch load would overwrite it, so that burst is CCs only.
+    if (! burstChanges.empty())
+    {
+        const bool allowDataSets = (sysExCapture != nullptr || directMidiOutputOpen.load()) && ! programChangeQueued;
+
+        fillKnownPatchBytes();
+        JP8080BurstCompiler::compile(burstChanges, partIndex, sysexDeviceId, knownPatchBytes, allowDataSets, outputBurst);
+        burstChanges.clear();
+
+        sendMidiCCBurst(midiMessages, outputBurst.controlChanges, currentMidiChannel);
+
+        for (int i = 0; i < outputBurst.numDataSets; ++i)
+            queueSysExDirect(outputBurst.dataSets[static_cast<size_t>(i)], currentBlockSamplePosition);
+    }
+}
+
+JP8080BurstCompiler::Change JP8080ControllerAudioProcessor::makeBurstChange (const juce::String& paramID,
+                                                                            int ccNumber, int midiValue) const
+{
+    using namespace JP8080Parameters;
+
+    // Patch values use the parameter's own range (e.g. 0-50 for OSC2 Range)
+    auto offset = patchOffsets.find(paramID);
+    if (offset == patchOffsets.end())
+        return { ccNumber, midiValue, -1, -1 };
+
+    return { ccNumber, midiValue, offset->second.offset,
+             juce::roundToInt(midiValue * offset->second.maxValue / 127.0f) };
+}
+
+void JP8080ControllerAudioProcessor::fillKnownPatchBytes()
+{
+    using namespace JP8080Parameters;
+
+    knownPatchBytes.fill(-1);
+
+    for (const auto& [paramID, offsetInfo] : patchOffsets)
+    {
+        // A held lock is not the knob value: leave it out of any DT1 range
+        const int lockIndex = JP8080LockSequencer::getLockIndex(paramID);
+        if (lockIndex >= 0 && activeLocks[static_cast<size_t>(lockIndex)])
+            continue;
+
+        auto* param = apvts.getParameter(paramID);
+        if (param == nullptr)
+            continue;
+
+        // What the hardware holds is the modulated value, as sent by processMidiOutput
+        const float plainValue = juce::jlimit(0.0f, 127.0f, param->convertFrom0to1(param->getValue())
+                                                              + modMatrix.getOffset(getKnobParameterIndex(paramID)));
+        const int value = juce::roundToInt(plainValue);
+        knownPatchBytes[static_cast<size_t>(offsetInfo.offset)] = static_cast<int16_t>(
+            dynamic_cast<juce::AudioParameterChoice*>(param) != nullptr
+                ? juce::jlimit(0, offsetInfo.maxValue, value)
+                : juce::roundToInt(value * offsetInfo.maxValue / 127.0f));
+    }
+}
+
+void JP8080ControllerAudioProcessor::processLockSequencer (juce::MidiBuffer& midiMessages, int numSamples,
+                                                           int partIndex, int channel)
+{
+    const int numTriggers = lockSequencer.process(currentPosition, partIndex, numSamples, getSampleRate(), lockTriggers);
+
+    // Transport stopped or sequencer off: every parameter goes back to its knob value
+    if (! lockSequencer.isPlaying())
+    {
+        if (activeLocks.any())
+            releaseLocks(midiMessages, activeLocks, 0, partIndex, channel);
+
+        activeLocks.reset();
+        return;
+    }
+
+    for (int i = 0; i < numTriggers; ++i)
+    {
+        const auto& trigger = lockTriggers[static_cast<size_t>(i)];
+        const auto& step = *trigger.step;
+
+        // Locks of the previous step that this one doesn't hold
+        releaseLocks(midiMessages, activeLocks & ~step.locks, trigger.sampleOffset, partIndex, channel);
+
+        // The step's precompiled events
+        sendMidiCCBurst(midiMessages, step.controlChanges, channel, trigger.sampleOffset);
+
+        for (const auto& sysex : step.sysExMessages)
+            queueSysExDirect(sysex.data, currentBlockSamplePosition >= 0 ? currentBlockSamplePosition + trigger.sampleOffset : -1);
+
+        activeLocks = step.locks;
+    }
+}
+
+void JP8080ControllerAudioProcessor::releaseLocks (juce::MidiBuffer& midiMessages,
+                                                   const JP8080LockSequencer::LockMask& locks,
+                                                   int sampleOffset, int partIndex, int channel)
+{
+    const auto& lockableIDs = JP8080LockSequencer::getLockableParameterIDs();
+
+    for (size_t i = 0; i < lockableIDs.size(); ++i)
+    {
+        if (! locks[i])
+            continue;
+
+        const auto& paramID = lockableIDs[i];
+        auto* param = apvts.getParameter(paramID);
+        if (param == nullptr)
+            continue;
+
+        const float plainValue = param->convertFrom0to1(param->getValue());
+        const int value = JP8080StepEmitter::toMidiValue(plainValue);
+        const int ccNumber = midiLearn.getTransmitCC(paramID);
+
+        // Back to the knob value, which change detection then takes as sent
+        if (ccNumber >= 0)
+        {
+            sendMidiCC(midiMessages, ccNumber, value, channel, param->getParameterIndex(), sampleOffset);
+            lastBlockValues[paramID] = plainValue;
+        }
+        else
+        {
+            if (writeWaveformSysEx(paramID, value, partIndex, sysExScratch))
+                queueSysExDirect(sysExScratch, currentBlockSamplePosition >= 0 ? currentBlockSamplePosition + sampleOffset : -1,
+                                param->getParameterIndex());
+        }
+
+        lastSentValues[paramID] = value;
+    }
+}
+
+void JP8080ControllerAudioProcessor::processMidiClock (juce::MidiBuffer& midiMessages, int numSamples)
+{
+    using namespace JP8080Parameters;
+
+    auto* clockParam = apvts.getParameter(Arpeggio::midiClock);
+    auto* tempoParam = apvts.getParameter(Arpeggio::tempo);
+
+    if (clockParam == nullptr || clockParam->getValue() < 0.5f || isOutputPaused())
+    {
+        midiClock.reset();
+        return;
+    }
+
+    // The performance tempo drives the clock when the host has no tempo of its own
+    const double fallbackBpm = tempoParam != nullptr ? tempoParam->convertFrom0to1(tempoParam->getValue()) : 120.0;
+
+    const int numEvents = midiClock.process(currentPosition, fallbackBpm, numSamples, getSampleRate(), clockEvents);
+    midiClock.schedule(midiMessages, clockEvents, numEvents, numSamples, getSampleRate());
+
+    metrics.countSent(JP8080Metrics::clock, numEvents);
+}
+
+void JP8080ControllerAudioProcessor::processMidiLearn (juce::MidiBuffer& midiMessages)
+{
+    bool filtered = false;
+    filteredMidi.clear();
+
+    for (const auto metadata : midiMessages)
+    {
+        const bool isControlChange = metadata.numBytes == 3 && (metadata.data[0] & 0xF0) == 0xB0;
+
+        if (isControlChange && midiLearn.handleControlChange((metadata.data[0] & 0x0F) + 1, metadata.data[1], metadata.data[2]))
+        {
+            filtered = true;
+            continue;
+        }
+
+        filteredMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+    }
+
+    if (filtered)
+        midiMessages.swapWith(filteredMidi);
+}
+
+void JP8080ControllerAudioProcessor::processScenes (juce::MidiBuffer& midiMessages, int numSamples)
+{
+    using namespace JP8080Parameters;
+
+    auto* selectParam = apvts.getParameter(Scene::select);
+    auto* fadeParam = apvts.getParameter(Scene::fadeTime);
+    auto* channelParam = apvts.getParameter(Scene::triggerChannel);
+
+    if (selectParam == nullptr || fadeParam == nullptr || channelParam == nullptr)
+        return;
+
+    const double fadeMs = fadeParam->convertFrom0to1(fadeParam->getValue());
+
+    auto recallScene = [this, fadeMs] (int sceneIndex)
+    {
+        // Without a fade the next block sends the difference to the synth as one burst
+        if (sceneBank.recall(sceneIndex, fadeMs, getSampleRate()) && fadeMs <= 0.0)
+            parameterJumpRequested = true;
+    };
+
+    // Notes on the trigger channel select scenes and are kept from the synth.
+    // A note recalls its scene even when it is already the selected one.
+    const int triggerChannel = juce::roundToInt(channelParam->convertFrom0to1(channelParam->getValue()));
+    int triggeredScene = -1;
+
+    if (triggerChannel > 0)
+    {
+        bool filtered = false;
+        filteredMidi.clear();
+
+        for (const auto metadata : midiMessages)
+        {
+            const int status = metadata.numBytes == 3 ? metadata.data[0] & 0xF0 : 0;
+            const bool isNote = (status == 0x90 || status == 0x80) && (metadata.data[0] & 0x0F) + 1 == triggerChannel;
+
+            if (! isNote)
+            {
+                filteredMidi.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+                continue;
             }
+
+            filtered = true;
+
+            const int sceneIndex = metadata.data[1] - sceneTriggerBaseNote;
+            if (status == 0x90 && metadata.data[2] > 0 && juce::isPositiveAndBelow(sceneIndex, JP8080SceneBank::numScenes))
+                triggeredScene = sceneIndex;
         }
+
+        if (filtered)
+            midiMessages.swapWith(filteredMidi);
+    }
+
+    if (triggeredScene >= 0)
+    {
+        lastSelectedScene = triggeredScene + 1;
+        selectParam->setValueNotifyingHost(selectParam->convertTo0to1(static_cast<float>(triggeredScene + 1)));
+        recallScene(triggeredScene);
+    }
+
+    // Host automation or the editor: recall when the Scene parameter changes,
+    // and stop any crossfade when it is switched off
+    const int selectedScene = juce::roundToInt(selectParam->convertFrom0to1(selectParam->getValue()));
+    const int previousScene = lastSelectedScene.exchange(selectedScene);
+
+    if (previousScene >= 0 && selectedScene != previousScene)
+    {
+        if (selectedScene > 0)
+            recallScene(selectedScene - 1);
+        else
+            sceneBank.cancelFade();
     }
+
+    sceneBank.process(numSamples);
 }
 
 //==============================================================================
@@ -361,11 +1375,14 @@ JP8080ControllerAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    // Helper lambda to create a standard 0-127 parameter
+    // Helper lambda to create a standard 0-127 parameter. Continuous, so automation
+    // keeps its full resolution; rounded to 7 bits only when sent.
     auto createStandardParam = [](const juce::String& id, const juce::String& name, float defaultValue = 64.0f)
     {
-        return std::make_unique<juce::AudioParameterInt>(
-            id, name, 0, 127, static_cast<int>(defaultValue));
+        return std::make_unique<juce::AudioParameterFloat>(
+            id, name, juce::NormalisableRange<float>(0.0f, 127.0f), defaultValue,
+            juce::AudioParameterFloatAttributes().withStringFromValueFunction(
+                [](float value, int) { return juce::String(juce::roundToInt(value)); }));
     };
 
     // Helper lambda to create a switch parameter (0-63=OFF, 64-127=ON)
@@ -483,6 +1500,94 @@ JP8080ControllerAudioProcessor::createParameterLayout()
         getDisplayName(MidiConfig::patchProgram),
         1, 64, 1)); // Range: 1-64, default: 1
 
+    // RPN: pitch bend range and master tuning
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        RPN::bendRange,
+        getDisplayName(RPN::bendRange),
+        0, 24, 2)); // Semitones, default: 2
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        RPN::fineTune,
+        getDisplayName(RPN::fineTune),
+        juce::NormalisableRange<float>(-50.0f, 50.0f), 0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("cents"))); // Default: A=440 Hz
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        RPN::coarseTune,
+        getDisplayName(RPN::coarseTune),
+        -24, 24, 0)); // Semitones
+
+    // ARPEGGIATOR / TEMPO (Performance Common, sent as SysEx)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::arpSwitch,
+        getDisplayName(Arpeggio::arpSwitch),
+        offOnNames,
+        0)); // Default: OFF
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::mode,
+        getDisplayName(Arpeggio::mode),
+        arpModeNames,
+        0)); // Default: UP
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::beatPattern,
+        getDisplayName(Arpeggio::beatPattern),
+        arpBeatPatternNames,
+        4)); // Default: 1/16
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::range,
+        getDisplayName(Arpeggio::range),
+        arpRangeNames,
+        0)); // Default: 1 OCT
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::hold,
+        getDisplayName(Arpeggio::hold),
+        offOnNames,
+        0)); // Default: OFF
+    layout.add(std::make_unique<juce::AudioParameterInt>(
+        Arpeggio::tempo,
+        getDisplayName(Arpeggio::tempo),
+        20, 250, 120)); // BPM
+
+    // MIDI clock out, locked to the host transport (the synth's MIDI sync must be on)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Arpeggio::midiClock,
+        getDisplayName(Arpeggio::midiClock),
+        offOnNames,
+        0)); // Default: OFF
+
+    // Scenes: selecting one recalls it, instantly or over the fade time
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Scene::select,
+        getDisplayName(Scene::select),
+        offOneToSixteenNames,
+        0)); // Default: OFF
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        Scene::fadeTime,
+        getDisplayName(Scene::fadeTime),
+        juce::NormalisableRange<float>(0.0f, 5000.0f, 1.0f, 0.4f),
+        0.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms"))); // Default: instant
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        Scene::triggerChannel,
+        getDisplayName(Scene::triggerChannel),
+        offOneToSixteenNames,
+        0)); // Default: OFF, all notes pass through
+
+    // Modulation matrix slots, all OFF by default
+    const auto modDestinationNames = getModDestinationNames();
+
+    for (int slot = 0; slot < ModMatrix::numSlots; ++slot)
+    {
+        const juce::String name = "Mod " + juce::String(slot + 1);
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ModMatrix::getSourceID(slot), name + " Source", modSourceNames, 0));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(
+            ModMatrix::getDestinationID(slot), name + " Destination", modDestinationNames, 0));
+        layout.add(std::make_unique<juce::AudioParameterInt>(
+            ModMatrix::getDepthID(slot), name + " Depth", -100, 100, 0)); // Percent of the full range
+        layout.add(std::make_unique<juce::AudioParameterInt>(
+            ModMatrix::getCurveID(slot), name + " Curve", -100, 100, 0)); // Default: linear
+    }
+
     return layout;
 }
 
@@ -492,8 +1597,15 @@ void JP8080ControllerAudioProcessor::getStateInformation (juce::MemoryBlock& des
     // Save parameter state to memory block
     auto state = apvts.copyState();
 
-    // Add MIDI output selection to state
+    // Add MIDI output and input selection to state
     state.setProperty("midiOutputId", selectedMidiOutputId, nullptr);
+    state.setProperty("midiInputId", selectedMidiInputId, nullptr);
+    state.setProperty("sysexDeviceId", static_cast<int>(sysexDeviceId.load()), nullptr);
+    state.setProperty("oscPort", getOSCPort(), nullptr);
+    state.setProperty("pauseWhenDisconnected", getPauseOutputWhenDisconnected(), nullptr);
+    state.appendChild(lockSequencer.toValueTree(), nullptr);
+    state.appendChild(sceneBank.toValueTree(), nullptr);
+    state.appendChild(midiLearn.toValueTree(), nullptr);
 
     std::unique_ptr<juce::XmlElement> xml (state.createXml());
     copyXmlToBinary (*xml, destData);
@@ -510,6 +1622,15 @@ void JP8080ControllerAudioProcessor::setStateInformation (const void* data, int
         {
             auto newState = juce::ValueTree::fromXml (*xmlState);
 
+            // Restore the synth's device ID before reopening its ports
+            if (newState.hasProperty("sysexDeviceId"))
+                setSysExDeviceId(static_cast<uint8_t>(static_cast<int>(newState.getProperty("sysexDeviceId"))));
+
+            if (newState.hasProperty("oscPort"))
+                setOSCPort(static_cast<int>(newState.getProperty("oscPort")));
+
+            setPauseOutputWhenDisconnected(newState.getProperty("pauseWhenDisconnected", false));
+
             // Restore MIDI output selection
             if (newState.hasProperty("midiOutputId"))
             {
@@ -517,7 +1638,32 @@ void JP8080ControllerAudioProcessor::setStateInformation (const void* data, int
                 setSelectedMidiOutput(midiOutputId);
             }
 
+            // Restore MIDI input selection
+            if (newState.hasProperty("midiInputId"))
+            {
+                juce::String midiInputId = newState.getProperty("midiInputId").toString();
+                setSelectedMidiInput(midiInputId);
+            }
+
+            // The lock pattern is ours, not a part of the parameter state
+            auto lockPattern = newState.getChildWithName("LockSequencer");
+            lockSequencer.fromValueTree(lockPattern);
+            newState.removeChild(lockPattern, nullptr);
+
+            auto scenes = newState.getChildWithName("Scenes");
+            sceneBank.fromValueTree(scenes);
+            newState.removeChild(scenes, nullptr);
+
+            auto midiLearnState = newState.getChildWithName("MidiLearn");
+            midiLearn.fromValueTree(midiLearnState);
+            newState.removeChild(midiLearnState, nullptr);
+
+            // The saved parameter values take precedence over the patch cache
+            const juce::ScopedValueSetter<bool> restoring (restoringState, true);
             apvts.replaceState (newState);
+
+            // The restored scene selection is not a switch
+            lastSelectedScene = -1;
         }
     }
 }
@@ -526,7 +1672,8 @@ void JP8080ControllerAudioProcessor::setStateInformation (const void* data, int
 // MIDI Output Methods
 
 void JP8080ControllerAudioProcessor::sendMidiCC (juce::MidiBuffer& midiMessages,
-                                                   int ccNumber, int value, int channel)
+                                                   int ccNumber, int value, int channel, int parameterIndex,
+                                                   int sampleOffset)
 {
     // Ensure values are in valid MIDI range
     ccNumber = juce::jlimit (0, 127, ccNumber);
@@ -537,8 +1684,32 @@ void JP8080ControllerAudioProcessor::sendMidiCC (juce::MidiBuffer& midiMessages,
     // MIDI channels are 0-15 internally, but displayed as 1-16
     auto message = juce::MidiMessage::controllerEvent (channel - 1, ccNumber, value);
 
-    // Add to MIDI buffer at sample position 0
-    midiMessages.addEvent (message, 0);
+    // Add to MIDI buffer at its position in the block
+    midiMessages.addEvent (message, sampleOffset);
+    metrics.countSent (JP8080Metrics::controlChange);
+    traceRecorder.record (JP8080TraceRecorder::outgoing, message.getRawData(), message.getRawDataSize(),
+                          currentBlockSamplePosition >= 0 ? currentBlockSamplePosition + sampleOffset : -1,
+                          parameterIndex);
+}
+
+void JP8080ControllerAudioProcessor::sendMidiCCBurst (juce::MidiBuffer& midiMessages,
+                                                        const std::vector<uint8_t>& runningStatusBytes,
+                                                        int channel, int sampleOffset)
+{
+    // The burst is stored with running status on channel 1. Each CC goes into
+    // the buffer as a full three-byte message at the same sample, in order,
+    // which is what the burst compiler costs it at.
+    const auto status = static_cast<uint8_t> (0xB0 | (juce::jlimit (1, 16, channel) - 1));
+
+    for (size_t i = 1; i + 1 < runningStatusBytes.size(); i += 2)
+    {
+        const uint8_t message[] = { status, runningStatusBytes[i], runningStatusBytes[i + 1] };
+
+        midiMessages.addEvent (message, 3, sampleOffset);
+        metrics.countSent (JP8080Metrics::controlChange);
+        traceRecorder.record (JP8080TraceRecorder::outgoing, message, 3,
+                              currentBlockSamplePosition >= 0 ? currentBlockSamplePosition + sampleOffset : -1);
+    }
 }
 
 void JP8080ControllerAudioProcessor::sendBankSelectAndProgramChange (juce::MidiBuffer& midiMessages,
@@ -567,6 +1738,9 @@ void JP8080ControllerAudioProcessor::sendBankSelectAndProgramChange (juce::MidiB
     // Send Program Change
     auto pcMessage = juce::MidiMessage::programChange(channel - 1, midiProgram);
     midiMessages.addEvent(pcMessage, 0);
+    metrics.countSent(JP8080Metrics::programChange);
+    traceRecorder.record(JP8080TraceRecorder::outgoing, pcMessage.getRawData(), pcMessage.getRawDataSize(),
+                         currentBlockSamplePosition);
 }
 
 //==============================================================================
@@ -574,12 +1748,8 @@ void JP8080ControllerAudioProcessor::sendBankSelectAndProgramChange (juce::MidiB
 
 uint8_t JP8080ControllerAudioProcessor::calculateRolandChecksum (const std::vector<uint8_t>& addressAndData)
 {
-    // Calculate Roland checksum: sum all bytes, then checksum = 128 - (sum mod 128)
-    int sum = 0;
-    for (uint8_t byte : addressAndData)
-        sum += byte;
-
-    return static_cast<uint8_t>(128 - (sum % 128));
+    // Sum of all bytes plus checksum is 0 mod 128; a sum of 0 mod 128 gives 00H, not 80H
+    return JP8080SysEx::calculateChecksum (addressAndData.data(), addressAndData.size());
 }
 
 void JP8080ControllerAudioProcessor::sendSysExMessage (juce::MidiBuffer& midiMessages,
@@ -588,11 +1758,23 @@ void JP8080ControllerAudioProcessor::sendSysExMessage (juce::MidiBuffer& midiMes
     // Create MIDI SysEx message and add to buffer
     auto message = juce::MidiMessage::createSysExMessage(sysexData.data(), static_cast<int>(sysexData.size()));
     midiMessages.addEvent(message, 0);
+    metrics.countSent(JP8080Metrics::sysEx);
+    traceRecorder.record(JP8080TraceRecorder::outgoing, message.getRawData(), message.getRawDataSize(),
+                         currentBlockSamplePosition);
 }
 
-void JP8080ControllerAudioProcessor::sendWaveformSysEx (juce::MidiBuffer& midiMessages,
-                                                          const juce::String& paramID,
-                                                          int waveformValue)
+std::vector<uint8_t> JP8080ControllerAudioProcessor::createWaveformSysEx (const juce::String& paramID,
+                                                                         int waveformValue, int partIndex)
+{
+    std::vector<uint8_t> message;
+    writeWaveformSysEx(paramID, waveformValue, partIndex, message);
+    return message;
+}
+
+// Builds into message, so reserved capacity avoids allocating; false (and
+// message left empty) for a parameter without a selector address
+bool JP8080ControllerAudioProcessor::writeWaveformSysEx (const juce::String& paramID, int waveformValue,
+                                                          int partIndex, std::vector<uint8_t>& message)
 {
     using namespace JP8080Parameters;
 
@@ -609,65 +1791,69 @@ void JP8080ControllerAudioProcessor::sendWaveformSysEx (juce::MidiBuffer& midiMe
     // sum = checksum
     // F7 = SysEx end
 
-    const uint8_t ROLAND_ID = 0x41;
-    const uint8_t DEVICE_ID = 0x10; // Default device ID
-    const uint8_t MODEL_ID_MSB = 0x00;
-    const uint8_t MODEL_ID_LSB = 0x06;
-    const uint8_t DT1_COMMAND = 0x12;
-
-    // Temporary Performance Patch base addresses:
-    // Upper part: 01 00 40 xx
-    // Lower part: 01 00 41 xx
-    const uint8_t ADDR_BYTE1 = 0x01;
-    const uint8_t ADDR_BYTE2 = 0x00;
-
-    // Get part selection (0 = Upper, 1 = Lower)
-    auto* partParam = apvts.getParameter(MidiConfig::part);
-    int partIndex = partParam != nullptr ? static_cast<int>(partParam->getValue() + 0.5f) : 0;
-    const uint8_t ADDR_BYTE3 = (partIndex == 0) ? 0x40 : 0x41; // Upper or Lower
-
-    uint8_t addrByte4 = 0x00;
+    // Offset within the temporary patch: Upper 01 00 40 00, Lower 01 00 42 00
+    int offset = 0;
 
-    // Determine the parameter offset based on parameter ID
     if (paramID == LFO::lfo1Waveform)
-        addrByte4 = 0x10; // LFO1 Waveform offset
+        offset = 0x10; // LFO1 Waveform offset
     else if (paramID == Oscillator::osc1Waveform)
-        addrByte4 = 0x1E; // OSC1 Waveform offset
+        offset = 0x1E; // OSC1 Waveform offset
     else if (paramID == Oscillator::osc2Waveform)
-        addrByte4 = 0x21; // OSC2 Waveform offset
+        offset = 0x21; // OSC2 Waveform offset
     else if (paramID == Effects::multiFxType)
-        addrByte4 = 0x3D; // Multi-FX Type offset
+        offset = 0x3D; // Multi-FX Type offset
     else if (paramID == Effects::delayType)
-        addrByte4 = 0x3F; // Delay Type offset
+        offset = 0x3F; // Delay Type offset
     else
-        return; // Unknown parameter, don't send
+    {
+        message.clear();
+        return false; // Unknown parameter, don't send
+    }
 
-    // Build address and data for checksum calculation
-    std::vector<uint8_t> addressAndData = {
-        ADDR_BYTE1, ADDR_BYTE2, ADDR_BYTE3, addrByte4,
-        static_cast<uint8_t>(waveformValue)
-    };
+    const auto address = JP8080SysEx::intToAddress(JP8080SysEx::addressToInt(JP8080SysEx::getTemporaryPatchAddress(partIndex))
+                                                   + offset);
+    const auto data = static_cast<uint8_t>(juce::jlimit(0, 127, waveformValue));
 
-    // Calculate checksum
-    uint8_t checksum = calculateRolandChecksum(addressAndData);
-
-    // Build SysEx message data (WITHOUT F0 and F7 - JUCE adds those automatically)
-    std::vector<uint8_t> sysexData = {
-        ROLAND_ID,      // Roland manufacturer ID
-        DEVICE_ID,      // Device ID
-        MODEL_ID_MSB,   // Model ID MSB
-        MODEL_ID_LSB,   // Model ID LSB (JP-8080)
-        DT1_COMMAND,    // DT1 command
-        ADDR_BYTE1,     // Address byte 1
-        ADDR_BYTE2,     // Address byte 2
-        ADDR_BYTE3,     // Address byte 3
-        addrByte4,      // Address byte 4
-        static_cast<uint8_t>(waveformValue), // Data
-        checksum        // Checksum
-    };
+    // Message data WITHOUT F0 and F7 - JUCE adds those automatically
+    JP8080SysEx::writeDataSet(sysexDeviceId, address, &data, 1, message);
+    return true;
+}
+
+void JP8080ControllerAudioProcessor::sendWaveformSysEx (juce::MidiBuffer& midiMessages,
+                                                          const juce::String& paramID,
+                                                          int waveformValue)
+{
+    using namespace JP8080Parameters;
+
+    // Get part selection (0 = Upper, 1 = Lower)
+    auto* partParam = apvts.getParameter(MidiConfig::part);
+    int partIndex = partParam != nullptr ? static_cast<int>(partParam->getValue() + 0.5f) : 0;
+
+    if (! writeWaveformSysEx(paramID, waveformValue, partIndex, sysExScratch))
+        return;
 
     // Send via direct MIDI output (bypasses DAW routing which filters SysEx)
-    sendSysExDirect(sysexData);
+    auto* param = apvts.getParameter(paramID);
+    queueSysExDirect(sysExScratch, currentBlockSamplePosition, param != nullptr ? param->getParameterIndex() : -1);
+}
+
+void JP8080ControllerAudioProcessor::sendPerformanceCommonSysEx (const juce::String& paramID, int value)
+{
+    using namespace JP8080Parameters;
+
+    auto offset = performanceCommonOffsets.find(paramID);
+    if (offset == performanceCommonOffsets.end())
+        return;
+
+    // DT1 to the temporary performance: 01 00 00 xx
+    std::array<uint8_t, 2> data;
+    const auto size = getPerformanceCommonData(paramID, value, data);
+    JP8080SysEx::writeDataSet(sysexDeviceId, JP8080SysEx::getTemporaryPerformanceCommonAddress(offset->second),
+                              data.data(), size, sysExScratch);
+
+    // Send via direct MIDI output (bypasses DAW routing which filters SysEx)
+    auto* param = apvts.getParameter(paramID);
+    queueSysExDirect(sysExScratch, currentBlockSamplePosition, param != nullptr ? param->getParameterIndex() : -1);
 }
 
 //==============================================================================
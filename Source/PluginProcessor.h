@@ -2,6 +2,25 @@
 
 #include <JuceHeader.h>
 #include "JP8080Parameters.h"
+#include "JP8080SysEx.h"
+#include "JP8080PatchCache.h"
+#include "JP8080BulkTransfer.h"
+#include "JP8080SysExReassembler.h"
+#include "JP8080SysExQueue.h"
+#include "JP8080ConnectionMonitor.h"
+#include "JP8080DeviceDiscovery.h"
+#include "JP8080Metrics.h"
+#include "JP8080TraceRecorder.h"
+#include "JP8080OSCServer.h"
+#include "JP8080StepEmitter.h"
+#include "JP8080RPNSequencer.h"
+#include "JP8080MidiClock.h"
+#include "JP8080SnapshotHistory.h"
+#include "JP8080LockSequencer.h"
+#include "JP8080BurstCompiler.h"
+#include "JP8080SceneBank.h"
+#include "JP8080MidiLearn.h"
+#include "JP8080ModMatrix.h"
 
 //==============================================================================
 /**
@@ -11,7 +30,12 @@
  * This plugin sends MIDI CC messages to control the JP-8080's parameters.
  */
 class JP8080ControllerAudioProcessor  : public juce::AudioProcessor,
-                                         private juce::AudioProcessorValueTreeState::Listener
+                                         private juce::AudioProcessorValueTreeState::Listener,
+                                         private juce::MidiInputCallback,
+                                         private JP8080SysExReassembler::Listener,
+                                         private juce::AsyncUpdater,
+                                         private juce::ChangeListener,
+                                         private juce::Timer
 {
 public:
     //==============================================================================
@@ -55,17 +79,107 @@ public:
     // Parameter access
     juce::AudioProcessorValueTreeState& getValueTreeState() { return apvts; }
 
+    // Knob parameters changed since the last call, one bit per getAllParameterIDs() index.
+    // Polled by the editor's refresh timer.
+    uint64_t takeDirtyKnobParameters() { return dirtyKnobParameters.exchange(0); }
+    int getKnobParameterIndex(const juce::String& paramID) const
+    {
+        auto it = knobParameterIndices.find(paramID);
+        return it != knobParameterIndices.end() ? it->second : -1;
+    }
+
 private:
     //==============================================================================
     // Parameter Management
     juce::AudioProcessorValueTreeState apvts;
 
+    // Undo steps and A/B slots. Values it recalls are sent as jumps by the next block.
+    JP8080SnapshotHistory snapshotHistory { *this };
+    std::atomic<bool> parameterJumpRequested { false };
+
+    // Scenes, recalled from processBlock by trigger notes and the Scene parameter.
+    // lastSelectedScene is -1 until the first block after a state change.
+    JP8080SceneBank sceneBank { *this };
+    std::atomic<int> lastSelectedScene { -1 };
+    void processScenes (juce::MidiBuffer& midiMessages, int numSamples);
+
+    // Learned controller routes and the CC each parameter is sent on
+    JP8080MidiLearn midiLearn { *this };
+    void processMidiLearn (juce::MidiBuffer& midiMessages);
+
+    // Incoming MIDI minus what was consumed as scene triggers or learned CCs
+    juce::MidiBuffer filteredMidi;
+
     // Parameter change callback
     void parameterChanged (const juce::String& parameterID, float newValue);
 
     // Create parameter layout for APVTS
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Editor refresh: knob parameters flagged on change, from any thread
+    std::map<juce::String, int> knobParameterIndices;
+    std::atomic<uint64_t> dirtyKnobParameters { 0 };
+
+    // Changes not yet sent, to count how many were coalesced
+    std::atomic<uint64_t> pendingOutputMask { 0 };
+    std::atomic<int> pendingOutputChanges { 0 };
+
+    // Bend range and tuning, sent as atomic RPN units from processBlock
+    JP8080RPNSequencer rpnSequencer { apvts };
+    JP8080RPNSequencer::Unit rpnUnit;
+
+    // Velocity, aftertouch, mod wheel and key as offsets on the knob parameters' output
+    JP8080ModMatrix modMatrix { apvts };
+
+    // MIDI clock locked to the host timeline, scheduled ahead of all other output
+    JP8080MidiClock midiClock;
+    JP8080MidiClock::EventList clockEvents;
+    void processMidiClock (juce::MidiBuffer& midiMessages, int numSamples);
+
+    // Parameter locks: steps starting in this block, and the locks currently held
+    JP8080LockSequencer lockSequencer { [this] (const juce::String& paramID, int value, int partIndex)
+                                        { return createWaveformSysEx(paramID, value, partIndex); },
+                                        [this] (const juce::String& paramID)
+                                        { return midiLearn.getTransmitCC(paramID); } };
+    JP8080LockSequencer::TriggerList lockTriggers;
+    JP8080LockSequencer::LockMask activeLocks;
+    void processLockSequencer (juce::MidiBuffer& midiMessages, int numSamples, int partIndex, int channel);
+    void releaseLocks (juce::MidiBuffer& midiMessages, const JP8080LockSequencer::LockMask& locks,
+                       int sampleOffset, int partIndex, int channel);
+
+    // Performance counters (see JP8080Metrics.h)
+    JP8080Metrics metrics;
+
+    // MIDI traffic trace, and the host position of the block being processed
+    JP8080TraceRecorder traceRecorder;
+    juce::int64 currentBlockSamplePosition = -1;
+
+    // OSC control endpoint, its changes are applied at the start of processBlock
+    JP8080OSCServer oscServer { *this, metrics };
+
+    // Parameter changes to MIDI, called from processBlock
+    void processMidiOutput (juce::MidiBuffer& midiMessages, int numSamples);
+
+    // Continuous parameters: value at the end of the previous block, swept
+    // from in the next one (see JP8080StepEmitter.h)
+    std::map<juce::String, float> lastBlockValues;
+    JP8080StepEmitter::StepList plannedSteps;
+
+    // Host playhead position of the block being processed
+    juce::Optional<juce::AudioPlayHead::PositionInfo> currentPosition;
+
+    // Recalls and resyncs: changes collected into one burst and encoded for
+    // the fewest bytes (see JP8080BurstCompiler.h)
+    std::vector<JP8080BurstCompiler::Change> burstChanges;
+    JP8080BurstCompiler::KnownPatchBytes knownPatchBytes;
+    JP8080BurstCompiler::Burst outputBurst;
+
+    // Audio thread: selector and Performance Common DT1s are built here,
+    // reserved in prepareToPlay, before they are copied into sysExQueue
+    std::vector<uint8_t> sysExScratch;
+    JP8080BurstCompiler::Change makeBurstChange (const juce::String& paramID, int ccNumber, int midiValue) const;
+    void fillKnownPatchBytes();
+
     // Track last sent parameter values to avoid redundant MIDI messages
     std::map<juce::String, int> lastSentValues;
     int lastSentBank = -1;
@@ -82,9 +196,27 @@ private:
     // Direct MIDI output for SysEx (bypasses DAW MIDI routing)
     std::unique_ptr<juce::MidiOutput> directMidiOutput;
     juce::String selectedMidiOutputId;
-    void sendSysExDirect(const std::vector<uint8_t>& sysexData);
+    // Any thread but the audio thread: blocks while another thread holds the output
+    void sendSysExDirect(const std::vector<uint8_t>& sysexData, juce::int64 samplePosition = -1, int parameterIndex = -1);
+    // Audio thread: hands the message to sysExQueue, or to sysExCapture while rendering
+    void queueSysExDirect(const std::vector<uint8_t>& sysexData, juce::int64 samplePosition, int parameterIndex = -1);
+    void writeSysExToOutput(const std::vector<uint8_t>& sysexData, juce::int64 samplePosition,
+                            int parameterIndex, juce::int64 startTicks);
+
+    // Receives the direct SysEx instead of the hardware while set (offline render)
+    std::function<void(const std::vector<uint8_t>&, juce::int64)> sysExCapture;
 
 public:
+    // Offline render: direct SysEx goes to the callback instead of the MIDI output.
+    // samplePosition is the host timeline position, or -1 if not sent from processBlock.
+    // Only set or clear it while processBlock isn't running; the audio thread reads it unlocked.
+    using SysExCapture = std::function<void(const std::vector<uint8_t>& sysexData, juce::int64 samplePosition)>;
+    void setSysExCapture(SysExCapture capture);
+
+    // Headless bridge: sends a processBlock's output straight to the MIDI output,
+    // as there is no host to route it
+    void sendMidiBufferDirect(const juce::MidiBuffer& midiMessages);
+
     // MIDI output device selection
     juce::Array<juce::MidiDeviceInfo> getAvailableMidiOutputs() const;
     juce::String getSelectedMidiOutputId() const { return selectedMidiOutputId; }
@@ -92,17 +224,180 @@ public:
     void setSelectedMidiOutput(const juce::String& deviceId);
     void refreshMidiOutput();
 
+    // MIDI input device selection (receives SysEx replies from the JP-8080)
+    juce::Array<juce::MidiDeviceInfo> getAvailableMidiInputs() const;
+    juce::String getSelectedMidiInputId() const { return selectedMidiInputId; }
+    void setSelectedMidiInput(const juce::String& deviceId);
+
+    // JP-8080 discovery
+    // Ports with a JP-8080 attached, found by the background discovery service
+    bool isJP8080Port(const juce::String& deviceId) const;
+    int getDeviceListGeneration() const { return deviceDiscovery->getGeneration(); }
+    void rescanDevices() { deviceDiscovery->rescan(); }
+
+    // SysEx device ID of the connected JP-8080 (10H-1FH)
+    uint8_t getSysExDeviceId() const { return sysexDeviceId.load(); }
+    void setSysExDeviceId(uint8_t newDeviceId);
+
+    // Patch cache
+    // Requests all user patches from the hardware in the background
+    void requestPatchCacheFill();
+    bool isPatchCacheFillRunning() const { return patchCacheFillThread.isThreadRunning(); }
+    JP8080PatchCache& getPatchCache() { return *patchCache; }
+
+    // Backup / restore of the user patches and performances as .syx
+    bool startBackup(const juce::File& destination);
+    bool startRestore(const juce::File& source);
+    JP8080BulkTransfer& getBulkTransfer() { return bulkTransfer; }
+
+    // Hardware connection state and round-trip latency
+    const JP8080ConnectionMonitor& getConnectionMonitor() const { return connectionMonitor; }
+
+    // Hold CC, program change, RPN and clock output while the synth's Active
+    // Sensing has stopped. Off by default.
+    void setPauseOutputWhenDisconnected(bool shouldPause) { pauseOutputWhenDisconnected = shouldPause; }
+    bool getPauseOutputWhenDisconnected() const { return pauseOutputWhenDisconnected.load(); }
+
+    // Message counters and timing histograms for diagnostics
+    JP8080Metrics& getMetrics() { return metrics; }
+
+    // Trace of all MIDI traffic, written to the Traces folder next to the patch cache
+    bool startTraceRecording();
+    void stopTraceRecording();
+    bool isTraceRecording() const { return traceRecorder.isRecording(); }
+    const JP8080TraceRecorder& getTraceRecorder() const { return traceRecorder; }
+
+    // OSC control for tablets and scripts (see JP8080OSCServer.h), 0 = off
+    bool setOSCPort(int port);
+    int getOSCPort() const { return oscServer.getPort(); }
+
+    // Undo history and A/B compare of the sound parameters (see JP8080SnapshotHistory.h)
+    JP8080SnapshotHistory& getSnapshotHistory() { return snapshotHistory; }
+
+    // Parameter-lock step sequencer, edited on the message thread (see JP8080LockSequencer.h)
+    JP8080LockSequencer& getLockSequencer() { return lockSequencer; }
+
+    // Scene bank, stored from the message thread (see JP8080SceneBank.h)
+    JP8080SceneBank& getSceneBank() { return sceneBank; }
+
+    // MIDI learn and transmit CC map, edited on the message thread (see JP8080MidiLearn.h)
+    JP8080MidiLearn& getMidiLearn() { return midiLearn; }
+
+    // Roland checksum of a DT1's address and data bytes (public for the bridge's --check)
+    static uint8_t calculateRolandChecksum (const std::vector<uint8_t>& addressAndData);
+
 private:
+    //==============================================================================
+    // Direct MIDI input (SysEx replies from the hardware)
+    std::unique_ptr<juce::MidiInput> directMidiInput;
+    juce::String selectedMidiInputId;
+    void handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message) override;
+    void handleDataSet (const JP8080SysEx::DataSet& dataSet, const uint8_t* sysexData, int sysexSize) override;
+    void handleIncomingDataSet (const JP8080SysEx::DataSet& dataSet);
+
+    // Reassembles and validates incoming SysEx without allocating
+    JP8080SysExReassembler sysexReassembler { *this };
+
+    // Guards directMidiOutput against being swapped while another thread sends
+    juce::CriticalSection directMidiOutputLock;
+    std::atomic<bool> directMidiOutputOpen { false };   // For the audio thread, which doesn't take the lock
+
+    // Audio thread -> SysEx sender thread, so processBlock never waits for directMidiOutputLock
+    JP8080SysExQueue sysExQueue { [this] (const std::vector<uint8_t>& sysexData, juce::int64 samplePosition,
+                                          int parameterIndex, juce::int64 queuedTicks)
+                                  { writeSysExToOutput(sysexData, samplePosition, parameterIndex, queuedTicks); } };
+
+    //==============================================================================
+    // Device discovery (shared between instances). Follows the configured synth
+    // when its ports are renamed or re-enumerated.
+    juce::SharedResourcePointer<JP8080DeviceDiscovery> deviceDiscovery;
+    std::atomic<uint8_t> sysexDeviceId { JP8080SysEx::defaultDeviceId };
+    bool selectedOutputPresent = true;
+    bool selectedInputPresent = true;
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+
+    //==============================================================================
+    // Patch cache recall
+    // Shared between plugin instances so the cache is loaded and filled once
+    juce::SharedResourcePointer<JP8080PatchCache> patchCache;
+
+    // Program changes recall the cached image on the message thread
+    void handleAsyncUpdate() override;
+    void recallPatchFromCache();
+    void applyCapturedPatch (int slot);
+    void applyPatchImageToParameters (const JP8080PatchCache::PatchImage& image);
+    std::atomic<bool> patchSelectionChanged { false };
+    int appliedPatchSlot = -1;                              // Message thread
+    JP8080PatchCache::PatchImage appliedPatchImage {};
+    bool getSelectedPatchSlot (int& bank, int& program) const;
+    int getSelectedPartIndex() const;
+    bool restoringState = false;
+
+    // Every recalled patch is read back from the temporary patch once the program
+    // change has been received, and applied again if the hardware's copy differs
+    void timerCallback() override;
+    static constexpr int temporaryPatchRequestDelayMs = 250;
+    std::atomic<int> pendingCaptureSlot { -1 };
+    std::atomic<int> temporaryCaptureSlot { -1 };
+    std::atomic<int> capturedPatchSlot { -1 };
+
+    // Recalled values already match the hardware, so processBlock adopts them
+    // as sent instead of echoing them back as CCs
+    std::atomic<bool> suppressParameterOutput { false };
+    std::atomic<bool> adoptParametersAsSent { false };
+    void markPatchParametersAsSent();
+
+    // Background RQ1 of the user patch area to fill the cache
+    class PatchCacheFillThread : public juce::Thread
+    {
+    public:
+        explicit PatchCacheFillThread (JP8080ControllerAudioProcessor& p)
+            : juce::Thread ("JP-8080 Patch Cache Fill"), processor (p) {}
+
+        void run() override;
+
+    private:
+        JP8080ControllerAudioProcessor& processor;
+    };
+
+    PatchCacheFillThread patchCacheFillThread { *this };
+    juce::WaitableEvent patchReceived;
+    static constexpr int patchReplyTimeoutMs = 500;
+    static constexpr int messageIntervalMs = 20;  // Minimum gap between messages to the JP-8080
+
+    bool isPatchCacheFillNeeded() const;
+
+    //==============================================================================
+    // Bulk transfer (runs on its own thread, never touches processBlock)
+    JP8080BulkTransfer bulkTransfer { [this] (const std::vector<uint8_t>& sysexData) { sendDataSetToHardware(sysexData); } };
+
+    // Sends a DT1 message and keeps the patch cache in step with what was written
+    void sendDataSetToHardware(const std::vector<uint8_t>& sysexData);
+
+    //==============================================================================
+    // Connection monitor: the full parameter state is resent once a dropped
+    // link comes back, and output is held while it is down if enabled
+    JP8080ConnectionMonitor connectionMonitor { [this] (const std::vector<uint8_t>& sysexData) { sendSysExDirect(sysexData); } };
+    std::atomic<bool> resyncRequested { false };
+    std::atomic<bool> pauseOutputWhenDisconnected { false };
+    void updateConnectionMonitor();
+    bool isOutputPaused() const { return pauseOutputWhenDisconnected.load() && connectionMonitor.isDisconnected(); }
+
 
     //==============================================================================
     // Helper methods for MIDI output
-    void sendMidiCC (juce::MidiBuffer& midiMessages, int ccNumber, int value, int channel);
+    void sendMidiCC (juce::MidiBuffer& midiMessages, int ccNumber, int value, int channel, int parameterIndex = -1,
+                     int sampleOffset = 0);
+    void sendMidiCCBurst (juce::MidiBuffer& midiMessages, const std::vector<uint8_t>& runningStatusBytes, int channel,
+                          int sampleOffset = 0);
     void sendBankSelectAndProgramChange (juce::MidiBuffer& midiMessages, int bank, int program, int channel);
 
     // SysEx helper methods
-    uint8_t calculateRolandChecksum (const std::vector<uint8_t>& addressAndData);
     void sendSysExMessage (juce::MidiBuffer& midiMessages, const std::vector<uint8_t>& sysexData);
     void sendWaveformSysEx (juce::MidiBuffer& midiMessages, const juce::String& paramID, int waveformValue);
+    std::vector<uint8_t> createWaveformSysEx (const juce::String& paramID, int waveformValue, int partIndex);
+    bool writeWaveformSysEx (const juce::String& paramID, int waveformValue, int partIndex, std::vector<uint8_t>& message);
+    void sendPerformanceCommonSysEx (const juce::String& paramID, int value);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JP8080ControllerAudioProcessor)